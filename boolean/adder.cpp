@@ -0,0 +1,149 @@
+/*
+ * adder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/adder.h>
+#include <boolean/parallel.h>
+
+namespace boolean
+{
+
+// A constant input reduces a full adder to a two input gate
+static cover half_sum(const cover &a, const cover &b, int c)
+{
+	return c ? xnor(a, b) : a ^ b;
+}
+
+// a ^ b ^ c
+cover full_sum(const cover &a, const cover &b, const cover &c)
+{
+	int k;
+	if ((k = c.constant()) >= 0)
+		return half_sum(a, b, k);
+	else if ((k = a.constant()) >= 0)
+		return half_sum(b, c, k);
+	else if ((k = b.constant()) >= 0)
+		return half_sum(a, c, k);
+
+	return (a ^ b) ^ c;
+}
+
+// The majority of a, b, and c
+cover full_carry(const cover &a, const cover &b, const cover &c)
+{
+	int k;
+	if ((k = c.constant()) >= 0)
+		return k ? a|b : a&b;
+	else if ((k = a.constant()) >= 0)
+		return k ? b|c : b&c;
+	else if ((k = b.constant()) >= 0)
+		return k ? a|c : a&c;
+
+	return (a&b) | (a&c) | (b&c);
+}
+
+static bitset ripple_carry(const bitset &n0, const bitset &n1, cover carry, bool carry_out)
+{
+	int n = (int)n0.bits.size();
+	bitset result;
+	result.bits.reserve(n+1);
+	for (int i = 0; i < n; i++)
+	{
+		result.bits.push_back(full_sum(n0.bits[i], n1.bits[i], carry));
+		if (carry_out or i+1 < n)
+			carry = full_carry(n0.bits[i], n1.bits[i], carry);
+	}
+	if (carry_out)
+		result.bits.push_back(carry);
+	return result;
+}
+
+// The prefix adders work on (generate, propagate) pairs in which position 0
+// is the carry in and position i+1 is bit i. Combining a span with the span
+// just below it gives
+//   G = G_hi | P_hi & G_lo
+//   P = P_hi & P_lo
+// Once a span reaches down to position 0, G is the carry out of that span.
+// Carries only need an inclusive propagate, so P is a|b rather than a^b.
+static void combine(vector<cover> &G, vector<cover> &P, const vector<cover> &G0, const vector<cover> &P0, int hi, int lo)
+{
+	G[hi] = G0[hi] | (P0[hi] & G0[lo]);
+	P[hi] = P0[hi] & P0[lo];
+}
+
+static void kogge_stone(vector<cover> &G, vector<cover> &P, int threads)
+{
+	int n = (int)G.size();
+	for (int d = 1; d < n; d *= 2)
+	{
+		vector<cover> G0 = G, P0 = P;
+		parallel_for(d, n, threads, [&](int i) {
+			combine(G, P, G0, P0, i, i-d);
+		});
+	}
+}
+
+static void brent_kung(vector<cover> &G, vector<cover> &P, int threads)
+{
+	int n = (int)G.size();
+	int d = 1;
+	// Up-sweep, combine pairs into spans of 2d
+	for (; 2*d <= n; d *= 2)
+	{
+		int count = (n - (2*d-1) + 2*d-1)/(2*d);
+		parallel_for(0, count, threads, [&](int k) {
+			int i = 2*d-1 + k*2*d;
+			combine(G, P, G, P, i, i-d);
+		});
+	}
+	// Down-sweep, fill in the positions between the spans
+	for (d /= 2; d >= 1; d /= 2)
+	{
+		int count = (n - (3*d-1) + 2*d-1)/(2*d);
+		if (count <= 0)
+			continue;
+		parallel_for(0, count, threads, [&](int k) {
+			int i = 3*d-1 + k*2*d;
+			combine(G, P, G, P, i, i-d);
+		});
+	}
+}
+
+bitset add(const bitset &n0, const bitset &n1, const cover &carry, int style, int threads, bool carry_out)
+{
+	unsigned long a, b;
+	int c = carry.constant();
+	if (n0.bits.size() < 64 and c >= 0 and n0.to_constant(&a) and n1.to_constant(&b))
+		return from_constant(a + b + c, n0.bits.size() + carry_out);
+
+	if (style == RIPPLE_CARRY)
+		return ripple_carry(n0, n1, carry, carry_out);
+
+	int n = (int)n0.bits.size();
+	vector<cover> G(n+1), P(n+1);
+	G[0] = carry;
+	P[0] = cover(0);
+	parallel_for(0, n, threads, [&](int i) {
+		G[i+1] = n0.bits[i] & n1.bits[i];
+		P[i+1] = n0.bits[i] | n1.bits[i];
+	});
+
+	if (style == KOGGE_STONE)
+		kogge_stone(G, P, threads);
+	else
+		brent_kung(G, P, threads);
+
+	bitset result;
+	result.bits.resize(n + carry_out);
+	parallel_for(0, n, threads, [&](int i) {
+		result.bits[i] = full_sum(n0.bits[i], n1.bits[i], G[i]);
+	});
+	if (carry_out)
+		result.bits[n] = G[n];
+	return result;
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * adder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/bitset.h>
+
+namespace boolean
+{
+
+// The structure used to build the carry chain of a symbolic addition.
+enum adder_style
+{
+	// Each carry is computed from the previous one.
+	RIPPLE_CARRY = 0,
+	// Parallel prefix with log2(n) levels of n combines each, the minimum
+	// depth at the cost of the most nodes.
+	KOGGE_STONE = 1,
+	// Parallel prefix with an up-sweep and down-sweep of 2*log2(n) levels,
+	// building roughly 2n nodes in total.
+	BRENT_KUNG = 2
+};
+
+cover full_sum(const cover &a, const cover &b, const cover &c);
+cover full_carry(const cover &a, const cover &b, const cover &c);
+
+// Add two bitsets of the same width and a carry in. The result has one more
+// bit than the operands, the carry out, unless carry_out is false. The nodes
+// within each level of a prefix adder are independent and are built on up to
+// threads threads.
+bitset add(const bitset &n0, const bitset &n1, const cover &carry, int style = RIPPLE_CARRY, int threads = 1, bool carry_out = true);
+
+}
@@ -0,0 +1,359 @@
+/*
+ * bdd.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/bdd.h>
+#include <boolean/hash.h>
+
+#include <algorithm>
+#include <climits>
+
+namespace boolean
+{
+
+// Operation codes for the computed cache.
+enum
+{
+	OP_AND = 0,
+	OP_XOR = 1,
+	OP_COFACTOR = 2
+};
+
+static uint64_t mix(uint64_t a, uint64_t b, uint64_t c)
+{
+	uint64_t h = a*0x9E3779B97F4A7C15ul ^ b*0xC2B2AE3D27D4EB4Ful ^ c*0x165667B19E3779F9ul;
+	h ^= h >> 31;
+	h *= 0xBF58476D1CE4E5B9ul;
+	h ^= h >> 29;
+	return h;
+}
+
+const unsigned int bdd::one;
+const unsigned int bdd::zero;
+
+bdd::bdd()
+{
+	clear();
+}
+
+bdd::~bdd()
+{
+}
+
+int bdd::size() const
+{
+	return (int)nodes.size();
+}
+
+void bdd::clear()
+{
+	nodes.clear();
+	unique.clear();
+	computed.clear();
+	converted.clear();
+
+	node terminal;
+	terminal.uid = INT_MAX;
+	terminal.lo = one;
+	terminal.hi = one;
+	nodes.push_back(terminal);
+}
+
+int bdd::top(unsigned int f) const
+{
+	return nodes[f>>1].uid;
+}
+
+unsigned int bdd::low(unsigned int f) const
+{
+	return nodes[f>>1].lo ^ (f&1);
+}
+
+unsigned int bdd::high(unsigned int f) const
+{
+	return nodes[f>>1].hi ^ (f&1);
+}
+
+void bdd::rehash(int capacity)
+{
+	unique.assign(capacity, 0);
+	unsigned int mask = (unsigned int)capacity-1;
+	for (unsigned int n = 1; n < (unsigned int)nodes.size(); n++) {
+		unsigned int i = (unsigned int)mix(nodes[n].uid, nodes[n].lo, nodes[n].hi) & mask;
+		while (unique[i] != 0)
+			i = (i+1) & mask;
+		unique[i] = n;
+	}
+}
+
+// Returns the slot for this operation. The cache grows with the number of
+// nodes, dropping everything in it.
+bdd::entry &bdd::lookup(unsigned int op, unsigned int f, unsigned int g)
+{
+	if (computed.size() < nodes.size() or computed.empty()) {
+		size_t capacity = 4096;
+		while (capacity < nodes.size())
+			capacity *= 2;
+
+		entry empty;
+		empty.op = ~0u;
+		empty.f = 0;
+		empty.g = 0;
+		empty.result = 0;
+		computed.assign(capacity, empty);
+	}
+
+	return computed[mix(op, f, g) & (computed.size()-1)];
+}
+
+// Get the edge for the node (uid, lo, hi), creating it if it doesn't exist.
+unsigned int bdd::make(int uid, unsigned int lo, unsigned int hi)
+{
+	if (lo == hi)
+		return lo;
+
+	// keep the high edge regular
+	if (hi & 1)
+		return make(uid, lo^1, hi^1)^1;
+
+	// keep the load factor at or below one half
+	if (2*nodes.size() > unique.size())
+		rehash(unique.empty() ? 1024 : 2*(int)unique.size());
+
+	unsigned int mask = (unsigned int)unique.size()-1;
+	unsigned int i = (unsigned int)mix(uid, lo, hi) & mask;
+	while (unique[i] != 0) {
+		const node &n = nodes[unique[i]];
+		if (n.uid == uid and n.lo == lo and n.hi == hi)
+			return unique[i]<<1;
+		i = (i+1) & mask;
+	}
+
+	node n;
+	n.uid = uid;
+	n.lo = lo;
+	n.hi = hi;
+	unique[i] = (unsigned int)nodes.size();
+	nodes.push_back(n);
+	return unique[i]<<1;
+}
+
+unsigned int bdd::var(int uid, int val)
+{
+	return val ? make(uid, zero, one) : make(uid, one, zero);
+}
+
+unsigned int bdd::apply_and(unsigned int f, unsigned int g)
+{
+	if (f == zero or g == zero or f == (g^1))
+		return zero;
+	if (f == one or f == g)
+		return g;
+	if (g == one)
+		return f;
+
+	if (f > g)
+		std::swap(f, g);
+
+	entry &e = lookup(OP_AND, f, g);
+	if (e.op == OP_AND and e.f == f and e.g == g)
+		return e.result;
+
+	int uid = std::min(top(f), top(g));
+	unsigned int f0 = top(f) == uid ? low(f) : f;
+	unsigned int f1 = top(f) == uid ? high(f) : f;
+	unsigned int g0 = top(g) == uid ? low(g) : g;
+	unsigned int g1 = top(g) == uid ? high(g) : g;
+
+	unsigned int lo = apply_and(f0, g0);
+	unsigned int hi = apply_and(f1, g1);
+	unsigned int result = make(uid, lo, hi);
+
+	// the recursion may have grown the cache
+	entry &r = lookup(OP_AND, f, g);
+	r.op = OP_AND;
+	r.f = f;
+	r.g = g;
+	r.result = result;
+	return result;
+}
+
+unsigned int bdd::apply_or(unsigned int f, unsigned int g)
+{
+	return apply_and(f^1, g^1)^1;
+}
+
+// Complements on either operand just complement the result, so only the
+// regular edges are cached.
+unsigned int bdd::apply_xor(unsigned int f, unsigned int g)
+{
+	unsigned int parity = (f^g)&1;
+	f &= ~1u;
+	g &= ~1u;
+
+	if (f == g)
+		return zero^parity;
+	if (f == one)
+		return g^1^parity;
+	if (g == one)
+		return f^1^parity;
+
+	if (f > g)
+		std::swap(f, g);
+
+	entry &e = lookup(OP_XOR, f, g);
+	if (e.op == OP_XOR and e.f == f and e.g == g)
+		return e.result^parity;
+
+	int uid = std::min(top(f), top(g));
+	unsigned int f0 = top(f) == uid ? low(f) : f;
+	unsigned int f1 = top(f) == uid ? high(f) : f;
+	unsigned int g0 = top(g) == uid ? low(g) : g;
+	unsigned int g1 = top(g) == uid ? high(g) : g;
+
+	unsigned int lo = apply_xor(f0, g0);
+	unsigned int hi = apply_xor(f1, g1);
+	unsigned int result = make(uid, lo, hi);
+
+	entry &r = lookup(OP_XOR, f, g);
+	r.op = OP_XOR;
+	r.f = f;
+	r.g = g;
+	r.result = result;
+	return result^parity;
+}
+
+unsigned int bdd::apply_not(unsigned int f) const
+{
+	return f^1;
+}
+
+unsigned int bdd::ite(unsigned int f, unsigned int g, unsigned int h)
+{
+	return apply_or(apply_and(f, g), apply_and(f^1, h));
+}
+
+unsigned int bdd::cofactor(unsigned int f, int uid, int val)
+{
+	if (top(f) > uid)
+		return f;
+	if (top(f) == uid)
+		return val ? high(f) : low(f);
+
+	unsigned int op = OP_COFACTOR + (val ? 1 : 0);
+	entry &e = lookup(op, f, (unsigned int)uid);
+	if (e.op == op and e.f == f and e.g == (unsigned int)uid)
+		return e.result;
+
+	unsigned int lo = cofactor(low(f), uid, val);
+	unsigned int hi = cofactor(high(f), uid, val);
+	unsigned int result = make(top(f), lo, hi);
+
+	entry &r = lookup(op, f, (unsigned int)uid);
+	r.op = op;
+	r.f = f;
+	r.g = (unsigned int)uid;
+	r.result = result;
+	return result;
+}
+
+// The conjunction of the literals, built bottom up from the largest uid.
+unsigned int bdd::build(const cube &c)
+{
+	if (c.is_null())
+		return zero;
+
+	unsigned int result = one;
+	for (int uid = c.size()*16-1; uid >= 0; uid--) {
+		int val = c.get(uid);
+		if (val == 0)
+			result = make(uid, result, zero);
+		else if (val == 1)
+			result = make(uid, zero, result);
+	}
+	return result;
+}
+
+// Balanced disjunction of the cubes in [lo, hi), which keeps the
+// intermediate diagrams smaller than folding left to right.
+unsigned int bdd::build(const cover &c, int lo, int hi)
+{
+	if (hi <= lo)
+		return zero;
+	if (hi-lo == 1)
+		return build(c.cubes[lo]);
+
+	int mid = (lo+hi)/2;
+	return apply_or(build(c, lo, mid), build(c, mid, hi));
+}
+
+unsigned int bdd::build(const cover &c)
+{
+	return build(c, 0, c.size());
+}
+
+void bdd::extract(unsigned int f, cube &path, cover &result) const
+{
+	if (f == zero)
+		return;
+	if (f == one) {
+		result.push_back(path);
+		return;
+	}
+
+	int uid = top(f);
+	path.set(uid, 0);
+	extract(low(f), path, result);
+	path.set(uid, 1);
+	extract(high(f), path, result);
+	path.set(uid, 2);
+}
+
+// Every path to the one terminal is a cube, and the paths are disjoint.
+cover bdd::extract(unsigned int f) const
+{
+	cover result;
+	cube path;
+	extract(f, path, result);
+	result.minimize();
+	return result;
+}
+
+unsigned int bdd::convert(const cover &c)
+{
+	hasher h;
+	c.hash(h);
+	vector<pair<cover, unsigned int> > &bucket = converted[h.get()];
+	for (int i = 0; i < (int)bucket.size(); i++)
+		if (bucket[i].first.cubes == c.cubes)
+			return bucket[i].second;
+
+	unsigned int result = build(c);
+	bucket.push_back(pair<cover, unsigned int>(c, result));
+	return result;
+}
+
+bool bdd::equal(const cover &s1, const cover &s2)
+{
+	return convert(s1) == convert(s2);
+}
+
+bool bdd::is_subset(const cover &s1, const cover &s2)
+{
+	return apply_and(convert(s1), convert(s2)^1) == zero;
+}
+
+bool bdd::is_tautology(const cover &s)
+{
+	return convert(s) == one;
+}
+
+bool bdd::are_mutex(const cover &s1, const cover &s2)
+{
+	return apply_and(convert(s1), convert(s2)) == zero;
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * bdd.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+#include <unordered_map>
+#include <stdint.h>
+
+using std::unordered_map;
+
+namespace boolean
+{
+
+// A reduced ordered binary decision diagram package. Variables are ordered
+// by uid, smallest at the root. Functions are referenced by edges: the node
+// index shifted left by one with the low bit marking a complemented edge.
+// The high edge of a stored node is never complemented, which together with
+// the unique table makes every function's edge canonical. Two functions are
+// equal exactly when their edges are equal, and negation is free.
+//
+// Nodes are never freed, they live until clear() is called.
+struct bdd
+{
+	bdd();
+	~bdd();
+
+	// The terminal node is node zero.
+	static const unsigned int one = 0;
+	static const unsigned int zero = 1;
+
+	struct node
+	{
+		int uid;
+		unsigned int lo;
+		unsigned int hi;
+	};
+
+	// A direct-mapped cache of previous operations, later results simply
+	// overwrite earlier ones in the same slot.
+	struct entry
+	{
+		unsigned int op;
+		unsigned int f;
+		unsigned int g;
+		unsigned int result;
+	};
+
+	vector<node> nodes;
+
+	// Linear probing table of node indices, zero marks an empty slot since
+	// the terminal is never stored in it. Its size is always a power of two.
+	vector<unsigned int> unique;
+	vector<entry> computed;
+
+	// Covers that have already been converted, keyed on the cover hash, so
+	// that repeated queries on the same functions skip the conversion.
+	unordered_map<uint64_t, vector<pair<cover, unsigned int> > > converted;
+
+	int size() const;
+	void clear();
+
+	unsigned int make(int uid, unsigned int lo, unsigned int hi);
+	unsigned int var(int uid, int val = 1);
+
+	unsigned int apply_and(unsigned int f, unsigned int g);
+	unsigned int apply_or(unsigned int f, unsigned int g);
+	unsigned int apply_xor(unsigned int f, unsigned int g);
+	unsigned int apply_not(unsigned int f) const;
+	unsigned int ite(unsigned int f, unsigned int g, unsigned int h);
+	unsigned int cofactor(unsigned int f, int uid, int val);
+
+	unsigned int build(const cube &c);
+	unsigned int build(const cover &c);
+	cover extract(unsigned int f) const;
+
+	// Answer queries on covers through their diagrams. Once both covers
+	// have been converted each of these is a single apply at most.
+	bool equal(const cover &s1, const cover &s2);
+	bool is_subset(const cover &s1, const cover &s2);
+	bool is_tautology(const cover &s);
+	bool are_mutex(const cover &s1, const cover &s2);
+
+private:
+	int top(unsigned int f) const;
+	unsigned int low(unsigned int f) const;
+	unsigned int high(unsigned int f) const;
+	unsigned int build(const cover &c, int lo, int hi);
+	unsigned int convert(const cover &c);
+	void extract(unsigned int f, cube &path, cover &result) const;
+	void rehash(int capacity);
+	entry &lookup(unsigned int op, unsigned int f, unsigned int g);
+};
+
+}
@@ -0,0 +1,396 @@
+/*
+ * binary.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/binary.h>
+#include <boolean/hash.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boolean
+{
+
+const uint64_t binary_file::magic;
+const uint32_t binary_file::version;
+
+cube_view::cube_view()
+{
+	values = NULL;
+	words = 0;
+}
+
+cube_view::cube_view(const unsigned int *values, int words)
+{
+	this->values = values;
+	this->words = words;
+}
+
+cube_view::~cube_view()
+{
+}
+
+int cube_view::size() const
+{
+	return words;
+}
+
+int cube_view::get(int uid) const
+{
+	unsigned int w = uid/16 < words ? values[uid/16] : 0xFFFFFFFF;
+	return (int)((w >> (2*(uid%16))) & 3) - 1;
+}
+
+bool cube_view::is_null() const
+{
+	for (int i = 0; i < words; i++)
+		if (((values[i] | (values[i] >> 1)) & 0x55555555) != 0x55555555)
+			return true;
+	return false;
+}
+
+cube cube_view::to_cube() const
+{
+	cube result;
+	result.values.assign(values, values+words);
+	return result;
+}
+
+cover_view::cover_view()
+{
+	words = NULL;
+	stride = 0;
+	count = 0;
+}
+
+cover_view::cover_view(const unsigned int *words, int stride, int count)
+{
+	this->words = words;
+	this->stride = stride;
+	this->count = count;
+}
+
+cover_view::~cover_view()
+{
+}
+
+int cover_view::size() const
+{
+	return count;
+}
+
+cube_view cover_view::operator[](int index) const
+{
+	return cube_view(words + (size_t)index*stride, stride);
+}
+
+cover cover_view::to_cover() const
+{
+	cover result;
+	result.cubes.resize(count);
+	for (int i = 0; i < count; i++)
+		result.cubes[i].values.assign(words + (size_t)i*stride, words + (size_t)(i+1)*stride);
+	return result;
+}
+
+binary_file::binary_file()
+{
+	data = NULL;
+	length = 0;
+	mapped = false;
+}
+
+binary_file::~binary_file()
+{
+	close();
+}
+
+const binary_header &binary_file::header() const
+{
+	return *(const binary_header*)data;
+}
+
+static const uint64_t *offsets(const char *data)
+{
+	return (const uint64_t*)(data + sizeof(binary_header));
+}
+
+static const unsigned int *words(const char *data)
+{
+	const binary_header &h = *(const binary_header*)data;
+	return (const unsigned int*)(data + sizeof(binary_header) + ((size_t)h.bits+1)*sizeof(uint64_t));
+}
+
+bool binary_file::open(const char *path)
+{
+	close();
+
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 or (size_t)st.st_size < sizeof(binary_header)) {
+		::close(fd);
+		return false;
+	}
+
+	void *mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = (const char*)mapped;
+	length = st.st_size;
+	this->mapped = true;
+	if (!check()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool binary_file::open(const char *data, size_t length)
+{
+	close();
+	if ((uintptr_t)data % alignof(uint64_t) != 0 or length < sizeof(binary_header))
+		return false;
+
+	this->data = data;
+	this->length = length;
+	mapped = false;
+	if (!check()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool binary_file::check() const
+{
+	// only a bitset holds anything other than exactly one cover, and the
+	// size of the cubes is checked by division so it can't overflow
+	const binary_header &h = header();
+	size_t table = sizeof(binary_header) + ((size_t)h.bits+1)*sizeof(uint64_t);
+	if (h.magic != magic or h.version != version or h.kind > BINARY_BITSET
+		or (h.kind != BINARY_BITSET and h.bits != 1)
+		or h.stride > INT_MAX or h.bits >= INT_MAX or table > length
+		or (h.stride != 0 and h.cubes > (length - table)/sizeof(unsigned int)/h.stride)
+		or table + h.cubes*h.stride*sizeof(unsigned int) != length)
+		return false;
+
+	// the covers have to tile the cubes in order
+	const uint64_t *start = offsets(data);
+	if (start[0] != 0 or start[h.bits] != h.cubes)
+		return false;
+	for (uint32_t i = 0; i < h.bits; i++)
+		if (start[i] > start[i+1] or start[i+1] - start[i] > INT_MAX)
+			return false;
+
+	return true;
+}
+
+void binary_file::close()
+{
+	if (data != NULL and mapped)
+		munmap((void*)data, length);
+	data = NULL;
+	length = 0;
+	mapped = false;
+}
+
+bool binary_file::is_open() const
+{
+	return data != NULL;
+}
+
+// Each cover is hashed the way cover::hash() would hash it.
+static uint64_t content_hash(const cover_view *views, int n)
+{
+	hasher h;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < views[i].size(); j++)
+			h.put(views[i][j].values, views[i].stride);
+		h.put((uint64_t)views[i].size());
+	}
+	return h.get();
+}
+
+bool binary_file::verify() const
+{
+	if (data == NULL)
+		return false;
+
+	vector<cover_view> views;
+	for (int i = 0; i < bits(); i++)
+		views.push_back(bit(i));
+	return content_hash(views.data(), (int)views.size()) == header().hash;
+}
+
+int binary_file::bits() const
+{
+	return data == NULL ? 0 : (int)header().bits;
+}
+
+// An empty view if there is no such cover.
+cover_view binary_file::bit(int index) const
+{
+	if (index < 0 or index >= bits())
+		return cover_view();
+
+	const binary_header &h = header();
+	const uint64_t *start = offsets(data);
+	return cover_view(words(data) + start[index]*h.stride, h.stride, (int)(start[index+1] - start[index]));
+}
+
+cube binary_file::to_cube() const
+{
+	cover_view v = bit(0);
+	return v.size() > 0 ? v[0].to_cube() : cube();
+}
+
+cover binary_file::to_cover() const
+{
+	return bit(0).to_cover();
+}
+
+bitset binary_file::to_bitset() const
+{
+	bitset result;
+	result.bits.resize(bits());
+	for (int i = 0; i < bits(); i++)
+		result.bits[i] = bit(i).to_cover();
+	return result;
+}
+
+// Lays out the covers and hands the bytes to emit in order, stopping at the
+// first call that fails.
+static bool encode(uint32_t kind, const cover *const *covers, int n, const std::function<bool(const void*, size_t)> &emit)
+{
+	binary_header h;
+	h.magic = binary_file::magic;
+	h.version = binary_file::version;
+	h.kind = kind;
+	h.stride = 0;
+	h.bits = n;
+	h.cubes = 0;
+
+	vector<uint64_t> start(n+1, 0);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < covers[i]->size(); j++)
+			h.stride = std::max(h.stride, (uint32_t)(*covers[i])[j].used_words());
+		h.cubes += covers[i]->size();
+		start[i+1] = h.cubes;
+	}
+
+	// hashed the same way a view of the file will be
+	hasher hash;
+	vector<unsigned int> padded(h.stride);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < covers[i]->size(); j++) {
+			const cube &c = (*covers[i])[j];
+			int m = std::min(c.size(), (int)h.stride);
+			memcpy(padded.data(), c.values.data(), m*sizeof(unsigned int));
+			std::fill(padded.begin()+m, padded.end(), 0xFFFFFFFF);
+			hash.put(padded.data(), h.stride);
+		}
+		hash.put((uint64_t)covers[i]->size());
+	}
+	h.hash = hash.get();
+
+	bool ok = emit(&h, sizeof(h));
+	ok = ok and emit(start.data(), start.size()*sizeof(uint64_t));
+
+	// stage the words so the output sees large writes
+	vector<unsigned int> buffer;
+	buffer.reserve(1 << 16);
+	for (int i = 0; i < n and ok; i++) {
+		for (int j = 0; j < covers[i]->size() and ok; j++) {
+			const cube &c = (*covers[i])[j];
+			int m = std::min(c.size(), (int)h.stride);
+			buffer.insert(buffer.end(), c.values.begin(), c.values.begin()+m);
+			buffer.insert(buffer.end(), h.stride-m, 0xFFFFFFFF);
+			if (buffer.size() >= (1 << 16)) {
+				ok = emit(buffer.data(), buffer.size()*sizeof(unsigned int));
+				buffer.clear();
+			}
+		}
+	}
+	if (ok and !buffer.empty())
+		ok = emit(buffer.data(), buffer.size()*sizeof(unsigned int));
+	return ok;
+}
+
+static bool write_covers(const char *path, uint32_t kind, const cover *const *covers, int n)
+{
+	FILE *fptr = fopen(path, "wb");
+	if (fptr == NULL)
+		return false;
+
+	bool ok = encode(kind, covers, n, [&](const void *data, size_t size) {
+		return fwrite(data, 1, size, fptr) == size;
+	});
+	ok = (fclose(fptr) == 0) and ok;
+	return ok;
+}
+
+bool write_binary(const char *path, const cube &c)
+{
+	cover single(c);
+	const cover *covers[1] = {&single};
+	return write_covers(path, BINARY_CUBE, covers, 1);
+}
+
+bool write_binary(const char *path, const cover &c)
+{
+	const cover *covers[1] = {&c};
+	return write_covers(path, BINARY_COVER, covers, 1);
+}
+
+bool write_binary(const char *path, const bitset &b)
+{
+	vector<const cover*> covers;
+	for (int i = 0; i < (int)b.bits.size(); i++)
+		covers.push_back(&b.bits[i]);
+	return write_covers(path, BINARY_BITSET, covers.data(), (int)covers.size());
+}
+
+void format_binary(const vector<cover> &covers, string &buffer)
+{
+	vector<const cover*> pointers;
+	for (int i = 0; i < (int)covers.size(); i++)
+		pointers.push_back(&covers[i]);
+	encode(BINARY_BITSET, pointers.data(), (int)pointers.size(), [&](const void *data, size_t size) {
+		buffer.append((const char*)data, size);
+		return true;
+	});
+}
+
+bool parse_binary(const char *data, size_t length, vector<cover> *result)
+{
+	// copied so the header and offsets are aligned wherever the image was
+	vector<uint64_t> aligned((length + sizeof(uint64_t)-1)/sizeof(uint64_t));
+	memcpy(aligned.data(), data, length);
+
+	binary_file file;
+	if (!file.open((const char*)aligned.data(), length) or !file.verify())
+		return false;
+
+	result->resize(file.bits());
+	for (int i = 0; i < file.bits(); i++)
+		(*result)[i] = file.bit(i).to_cover();
+	return true;
+}
+
+}
@@ -0,0 +1,125 @@
+/*
+ * binary.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/bitset.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+using std::string;
+
+namespace boolean
+{
+
+// A versioned binary format for cubes, covers and bitsets. The file is a
+// header, a table of where each cover starts, and then the words of every
+// cube back to back. Every cube is padded with tautology words to the same
+// stride so that cube i of a file is at a fixed offset, and the header
+// carries a hash of the contents computed with the same hash() hooks as
+// the in-memory structures.
+enum binary_kind
+{
+	BINARY_CUBE = 0,
+	BINARY_COVER = 1,
+	BINARY_BITSET = 2
+};
+
+struct binary_header
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t kind;
+	// Words per cube.
+	uint32_t stride;
+	// Covers in the file, one for a cube or a cover.
+	uint32_t bits;
+	uint64_t cubes;
+	uint64_t hash;
+};
+
+// A cube stored somewhere else, read in place.
+struct cube_view
+{
+	cube_view();
+	cube_view(const unsigned int *values, int words);
+	~cube_view();
+
+	const unsigned int *values;
+	int words;
+
+	int size() const;
+	int get(int uid) const;
+	bool is_null() const;
+	cube to_cube() const;
+};
+
+// A cover stored somewhere else, read in place.
+struct cover_view
+{
+	cover_view();
+	cover_view(const unsigned int *words, int stride, int count);
+	~cover_view();
+
+	const unsigned int *words;
+	int stride;
+	int count;
+
+	int size() const;
+	cube_view operator[](int index) const;
+	cover to_cover() const;
+};
+
+// A memory mapped binary file. The views it hands out point into the
+// mapping, so they are only valid while the file is open.
+struct binary_file
+{
+	binary_file();
+	~binary_file();
+
+	static const uint64_t magic = 0x314E4942424F4F42ull;
+	static const uint32_t version = 1;
+
+	const char *data;
+	size_t length;
+	bool mapped;
+
+	// Maps the file and checks that the header and sizes are consistent.
+	// The contents are only hashed by verify().
+	bool open(const char *path);
+	// Reads an image already in memory, which has to stay valid and be
+	// aligned to 8 bytes. It is checked the same way as a file.
+	bool open(const char *data, size_t length);
+	void close();
+	bool is_open() const;
+	bool verify() const;
+
+	const binary_header &header() const;
+	int bits() const;
+	cover_view bit(int index) const;
+
+	cube to_cube() const;
+	cover to_cover() const;
+	bitset to_bitset() const;
+
+private:
+	bool check() const;
+};
+
+bool write_binary(const char *path, const cube &c);
+bool write_binary(const char *path, const cover &c);
+bool write_binary(const char *path, const bitset &b);
+
+// The same image write_binary() writes for a bitset of these covers,
+// appended to buffer, so other formats can embed covers in this layout.
+// parse_binary() reads one back, failing unless it checks and verifies.
+void format_binary(const vector<cover> &covers, string &buffer);
+bool parse_binary(const char *data, size_t length, vector<cover> *result);
+
+}
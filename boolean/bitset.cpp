@@ -6,8 +6,11 @@
  */
 
 #include <boolean/bitset.h>
+#include <boolean/parallel.h>
+#include <boolean/trace.h>
 
 #include <algorithm>
+#include <memory>
 
 namespace boolean
 {
@@ -109,6 +112,25 @@ bool bitset::is_constant() const
 	return true;
 }
 
+// Store the bits in value and return true when every bit is trivially
+// constant, see cover::constant(). Bitsets wider than 64 bits are never
+// constant here.
+bool bitset::to_constant(unsigned long *value) const
+{
+	if (bits.size() > 64)
+		return false;
+
+	*value = 0;
+	for (int i = 0; i < (int)bits.size(); i++)
+	{
+		int c = bits[i].constant();
+		if (c < 0)
+			return false;
+		*value |= (unsigned long)c << i;
+	}
+	return true;
+}
+
 int bitset::max_width() const
 {
 	int result = 0;
@@ -313,44 +335,92 @@ float bitset::partition(bitset &left, bitset &right) const
 	return a.weight;
 }
 
-bitset bitset::decompose_hfactor(map<boolean::cube, int> &factors, int width, int offset, vector<int> hide) const
+// Decompositions are computed in two phases. First we build the tree of
+// partitions and cofactors, which is where all of the real work is done. The
+// two halves of a partition are independent of one another, so they may be
+// built on separate threads. Then we walk the finished tree depth-first,
+// assigning factor indices in the same order a purely sequential recursion
+// would and assembling the resulting bitset. If the current task is
+// cancelled, the remaining nodes are left as leaves, so the result is still
+// equal to the input, just less decomposed.
+struct factoring
 {
-	if (max_width() >= width and depth() > 1) {
-		boolean::cube common = supercube();
+	enum
+	{
+		LEAF = 0,
+		SPLIT = 1,
+		FACTOR = 2
+	};
+
+	factoring()
+	{
+		type = LEAF;
+		invert = false;
+		index = -1;
+	}
+	~factoring() {}
+
+	int type;
+	// This node computes the complement of its result.
+	bool invert;
+	// The remaining function of a LEAF.
+	bitset value;
+	// The cube pulled out of a FACTOR.
+	cube common;
+	int index;
+
+	// SPLIT uses both, FACTOR only uses left
+	std::unique_ptr<factoring> left;
+	std::unique_ptr<factoring> right;
+};
+
+static void build_hfactor(factoring &node, const bitset &f, int width, const vector<int> &hide, int threads)
+{
+	if (f.max_width() >= width and f.depth() > 1 and !is_cancelled()) {
+		boolean::cube common = f.supercube();
 		common.hide(hide);
 		if (common.width() < width)
 		{
+			// the partition relies on tautology checks, which can't be
+			// trusted once the task is cancelled
 			bitset c_left, c_right;
-			bitset result, left_result, right_result;
-			partition(c_left, c_right);
+			f.partition(c_left, c_right);
+			if (is_cancelled()) {
+				node.value = f;
+				return;
+			}
 
-			left_result = c_left.decompose_hfactor(factors, width, offset, hide);
-			right_result = c_right.decompose_hfactor(factors, width, offset, hide);
-			return left_result | right_result;
+			node.type = factoring::SPLIT;
+			node.left.reset(new factoring());
+			node.right.reset(new factoring());
+			fork_join(threads,
+				[&](int t) { build_hfactor(*node.left, c_left, width, hide, t); },
+				[&](int t) { build_hfactor(*node.right, c_right, width, hide, t); });
 		}
 		else
 		{
-			int index = -1;
-			map<boolean::cube, int>::iterator loc = factors.find(common);
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(common, index));
-			} else {
-				index = loc->second;
-			}
-
-			return boolean::cube(index, 1) & boolean::cofactor(*this, common).decompose_hfactor(factors, width, offset, hide);
+			node.type = factoring::FACTOR;
+			node.common = common;
+			node.left.reset(new factoring());
+			build_hfactor(*node.left, boolean::cofactor(f, common), width, hide, threads);
 		}
+		return;
 	}
 
-	return *this;
+	node.value = f;
 }
 
-bitset bitset::decompose_xfactor(map<boolean::cube, int> &factors, int width, int offset, vector<int> hide) const
+static void build_xfactor(factoring &node, const bitset &f, int width, const vector<int> &hide, int threads)
 {
-	if (max_width() >= width and depth() > 1) {
-		bitset nc = ~*this;
-		boolean::cube common = supercube();
+	if (f.max_width() >= width and f.depth() > 1 and !is_cancelled()) {
+		// the complement is cut short if the task is cancelled while it runs
+		bitset nc = ~f;
+		if (is_cancelled()) {
+			node.value = f;
+			return;
+		}
+
+		boolean::cube common = f.supercube();
 		boolean::cube ncommon = nc.supercube();
 		common.hide(hide);
 		ncommon.hide(hide);
@@ -358,51 +428,157 @@ bitset bitset::decompose_xfactor(map<boolean::cube, int> &factors, int width, in
 
 		if (cw < width and ncw < width) {
 			bitset c_left, c_right, nc_left, nc_right;
-			bitset result, left_result, right_result;
 			float c_weight, nc_weight;
-			
-			c_weight = partition(nc_left, c_right);
-			nc_weight = nc.partition(nc_left, nc_right);
+
+			fork_join(threads,
+				[&](int t) { c_weight = f.partition(c_left, c_right); },
+				[&](int t) { nc_weight = nc.partition(nc_left, nc_right); });
+			if (is_cancelled()) {
+				node.value = f;
+				return;
+			}
 
 			if (c_weight <= nc_weight)
 			{
-				left_result = c_left.decompose_xfactor(factors, width, offset, hide);
-				right_result = c_right.decompose_xfactor(factors, width, offset, hide);
-				result = left_result | right_result;
+				node.type = factoring::SPLIT;
+				node.left.reset(new factoring());
+				node.right.reset(new factoring());
+				fork_join(threads,
+					[&](int t) { build_xfactor(*node.left, c_left, width, hide, t); },
+					[&](int t) { build_xfactor(*node.right, c_right, width, hide, t); });
 			}
 			else if (nc_weight < c_weight)
 			{
-				left_result = nc_left.decompose_xfactor(factors, width, offset, hide);
-				right_result = nc_right.decompose_xfactor(factors, width, offset, hide);
-				result = ~(left_result | right_result);
+				node.type = factoring::SPLIT;
+				node.invert = true;
+				node.left.reset(new factoring());
+				node.right.reset(new factoring());
+				fork_join(threads,
+					[&](int t) { build_xfactor(*node.left, nc_left, width, hide, t); },
+					[&](int t) { build_xfactor(*node.right, nc_right, width, hide, t); });
 			}
-			return result;
+			return;
 		} else if (cw >= ncw) {
-			map<boolean::cube, int>::iterator loc = factors.find(common);
-			int index = -1;
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(common, index));
-			} else {
-				index = loc->second;
-			}
-		
-			return boolean::cube(index, 1) & boolean::cofactor(*this, common).decompose_xfactor(factors, width, offset, hide);
-		} else if (ncw > cw) {
-			map<boolean::cube, int>::iterator loc = factors.find(ncommon);
-			int index = -1;
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(ncommon, index));
-			} else {
-				index = loc->second;
-			}
-			
-			return ~(boolean::cube(index, 1) & boolean::cofactor(nc, ncommon).decompose_xfactor(factors, width, offset, hide));
+			node.type = factoring::FACTOR;
+			node.common = common;
+			node.left.reset(new factoring());
+			build_xfactor(*node.left, boolean::cofactor(f, common), width, hide, threads);
+			return;
+		} else {
+			node.type = factoring::FACTOR;
+			node.invert = true;
+			node.common = ncommon;
+			node.left.reset(new factoring());
+			build_xfactor(*node.left, boolean::cofactor(nc, ncommon), width, hide, threads);
+			return;
 		}
 	}
 
-	return *this;
+	node.value = f;
+}
+
+template <typename table>
+static void assign_factors(factoring &node, table &factors, int offset)
+{
+	if (node.type == factoring::FACTOR)
+		node.index = factor_index(factors, node.common, offset);
+
+	if (node.left)
+		assign_factors(*node.left, factors, offset);
+	if (node.right)
+		assign_factors(*node.right, factors, offset);
+}
+
+static bitset assemble(const factoring &node, int threads)
+{
+	bitset result;
+	if (node.type == factoring::SPLIT) {
+		bitset left_result, right_result;
+		fork_join(threads,
+			[&](int t) { left_result = assemble(*node.left, t); },
+			[&](int t) { right_result = assemble(*node.right, t); });
+		result = left_result | right_result;
+	} else if (node.type == factoring::FACTOR) {
+		result = boolean::cube(node.index, 1) & assemble(*node.left, threads);
+	} else {
+		result = node.value;
+	}
+
+	if (node.invert)
+		result = ~result;
+	return result;
+}
+
+// The tree is already built, so the complements of the inverted nodes have
+// to be computed in full even if the task was cancelled.
+static bitset finish(const factoring &node, int threads)
+{
+	task_scope scope(NULL);
+	return assemble(node, threads);
+}
+
+bitset bitset::decompose_hfactor(factor_table &factors, int width, int offset, vector<int> hide, int threads) const
+{
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_HFACTOR, *this, width, offset, hide, threads));
+
+	factoring root;
+	report_progress("decompose", 0, 2);
+	build_hfactor(root, *this, width, hide, threads);
+	report_progress("decompose", 1, 2);
+	assign_factors(root, factors, offset);
+	bitset result = finish(root, threads);
+	report_progress("decompose", 2, 2);
+	return result;
+}
+
+bitset bitset::decompose_xfactor(factor_table &factors, int width, int offset, vector<int> hide, int threads) const
+{
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_XFACTOR, *this, width, offset, hide, threads));
+
+	factoring root;
+	report_progress("decompose", 0, 2);
+	build_xfactor(root, *this, width, hide, threads);
+	report_progress("decompose", 1, 2);
+	assign_factors(root, factors, offset);
+	bitset result = finish(root, threads);
+	report_progress("decompose", 2, 2);
+	return result;
+}
+
+bitset bitset::decompose_hfactor(map<boolean::cube, int> &factors, int width, int offset, vector<int> hide, int threads) const
+{
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_HFACTOR, *this, width, offset, hide, threads));
+
+	factoring root;
+	report_progress("decompose", 0, 2);
+	build_hfactor(root, *this, width, hide, threads);
+	report_progress("decompose", 1, 2);
+	assign_factors(root, factors, offset);
+	bitset result = finish(root, threads);
+	report_progress("decompose", 2, 2);
+	return result;
+}
+
+bitset bitset::decompose_xfactor(map<boolean::cube, int> &factors, int width, int offset, vector<int> hide, int threads) const
+{
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_XFACTOR, *this, width, offset, hide, threads));
+
+	factoring root;
+	report_progress("decompose", 0, 2);
+	build_xfactor(root, *this, width, hide, threads);
+	report_progress("decompose", 1, 2);
+	assign_factors(root, factors, offset);
+	bitset result = finish(root, threads);
+	report_progress("decompose", 2, 2);
+	return result;
 }
 
 
@@ -442,6 +618,15 @@ bitset &bitset::operator>>=(int s)
 	return *this;
 }
 
+bitset from_constant(unsigned long value, int width)
+{
+	bitset result;
+	result.bits.reserve(width);
+	for (int i = 0; i < width; i++)
+		result.bits.push_back(cover(i < 64 ? (int)((value >> i) & 1) : 0));
+	return result;
+}
+
 bitset cofactor(const bitset &s0, const cube &s1)
 {
 	bitset result;
@@ -650,26 +835,38 @@ cover operator==(const bitset &n0, const bitset &n1)
 
 	// if n1 has more bits than n0, all it takes is one of those bits
 	// to be set for n0 to be less than n1
-	conjunction &= (n0.extend()&n1.extend()) | (~n0.extend()&~n1.extend());
+	conjunction &= xnor(n0.extend(), n1.extend());
 	for (int i = (int)n1.bits.size()-1; i >= (int)n0.bits.size(); i--)
-		conjunction &= (n0.extend()&n1.bits[i]) | (~n0.extend()&~n1.bits[i]);
+		conjunction &= xnor(n0.extend(), n1.bits[i]);
 	for (int i = (int)n0.bits.size()-1; i >= (int)n1.bits.size(); i--)
-		conjunction &= (n0.bits[i]&n1.extend()) | (~n0.bits[i]&~n1.extend());
+		conjunction &= xnor(n0.bits[i], n1.extend());
 
 	if (not conjunction.is_null()) {
 		int m = (int)std::min((int)n0.bits.size()-1, (int)n1.bits.size()-1);
 		for (int i = m; i >= 0; i--)
 		{
-			conjunction &= (n0.bits[i]&n1.bits[i]) | (~n0.bits[i]&~n1.bits[i]);
+			conjunction &= xnor(n0.bits[i], n1.bits[i]);
 		}
 	}
 
 	return conjunction;
 }
 
+// Any differing bit, which avoids complementing the whole of n0 == n1
 cover operator!=(const bitset &n0, const bitset &n1)
 {
-	return ~(n0 == n1);
+	cover_builder disjunction;
+	disjunction |= n0.extend() ^ n1.extend();
+	for (int i = (int)n1.bits.size()-1; i >= (int)n0.bits.size(); i--)
+		disjunction |= n0.extend() ^ n1.bits[i];
+	for (int i = (int)n0.bits.size()-1; i >= (int)n1.bits.size(); i--)
+		disjunction |= n0.bits[i] ^ n1.extend();
+
+	int m = (int)std::min(n0.bits.size(), n1.bits.size());
+	for (int i = 0; i < m; i++)
+		disjunction |= n0.bits[i] ^ n1.bits[i];
+
+	return disjunction.get();
 }
 
 }
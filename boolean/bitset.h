@@ -8,6 +8,7 @@
 #pragma once
 
 #include <boolean/cover.h>
+#include <boolean/factor_table.h>
 
 #include <vector>
 #include <map>
@@ -39,13 +40,22 @@ struct bitset
 	virtual cover extend() const;
 	cube supercube() const;
 	bool is_constant() const;
+	bool to_constant(unsigned long *value) const;
 	int max_width() const;
 	int depth() const;
 	
 	void cofactor(const cube &s1);
 	float partition(bitset &left, bitset &right) const;
-	bitset decompose_hfactor(map<boolean::cube, int> &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>()) const;
-	bitset decompose_xfactor(map<boolean::cube, int> &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>()) const;
+
+	// Factor out common cubes until every cube has fewer than width literals,
+	// recording each factor in the table. The left and right halves of each
+	// partition are independent, so up to threads of them are decomposed
+	// concurrently. Factor indices are assigned afterward in a single
+	// depth-first pass, so the result does not depend on threads.
+	bitset decompose_hfactor(factor_table &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>(), int threads = 1) const;
+	bitset decompose_xfactor(factor_table &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>(), int threads = 1) const;
+	bitset decompose_hfactor(map<boolean::cube, int> &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>(), int threads = 1) const;
+	bitset decompose_xfactor(map<boolean::cube, int> &factors, int width = 2, int offset = 0, vector<int> hide = vector<int>(), int threads = 1) const;
 
 	bitset &operator=(const bitset &n);
 
@@ -56,6 +66,9 @@ struct bitset
 	bitset &operator>>=(int s);
 };
 
+// The low width bits of value as constant covers.
+bitset from_constant(unsigned long value, int width);
+
 bitset cofactor(const bitset &s0, const cube &s1);
 
 bitset operator&(const bitset &n0, const bitset &n1);
@@ -6,6 +6,10 @@
  */
 
 #include <boolean/cover.h>
+#include <boolean/truth_table.h>
+#include <boolean/sat.h>
+#include <boolean/task.h>
+#include <boolean/trace.h>
 
 #include <algorithm>
 #include <bit>
@@ -152,6 +156,12 @@ bool cover::is_subset_of(const cube &s) const
 
 bool cover::is_subset_of(const cover &s) const
 {
+	vector<int> support;
+	if (small_support(*this, s, &support))
+		return truth_table(*this, support).is_subset_of(truth_table(s, support));
+	else if (!small_support(*this, s, &support, sat::min_support))
+		return sat_is_subset(*this, s);
+
 	for (int i = 0; i < (int)cubes.size(); i++)
 		if (!cubes[i].is_subset_of(s))
 			return false;
@@ -162,6 +172,10 @@ bool cover::is_subset_of(const cover &s) const
 // check if this cover covers all cubes
 bool cover::is_tautology() const
 {
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_TAUTOLOGY, *this));
+
 	// Cover F is empty
 	if (size() == 0)
 		return false;
@@ -195,6 +209,15 @@ bool cover::is_tautology() const
 
 		return result.is_tautology();
 	}
+
+	// If the cover only uses a few variables, check a truth table of its
+	// support
+	vector<int> support;
+	vars(&support);
+	if ((int)support.size() <= truth_table::max_support)
+		return truth_table(*this, support).is_tautology();
+	else if (is_cancelled())
+		return false;
 	else
 	{
 		// There are too many variables, so we'll use shannon expansion.
@@ -240,8 +263,11 @@ bool cover::is_tautology() const
 		// Select a binate variable
 		pair<int, int> uid = *max_element(binate_rank.begin(), binate_rank.end());
 
-		// Do the shannon expansion, and recurse on the cofactors
-		if (uid.first > 0)
+		// Do the shannon expansion, and recurse on the cofactors. Wide binate
+		// covers blow up the recursion, so those go to the solver instead.
+		if (uid.first > 0 and (int)support.size() > sat::min_support)
+			return sat_is_tautology(*this);
+		else if (uid.first > 0)
 		{
 			if (!boolean::cofactor(*this, uid.second, 0).is_tautology())
 				return false;
@@ -268,6 +294,22 @@ bool cover::is_null() const
 	return true;
 }
 
+// Returns 0 or 1 if this cover is trivially the constant 0 or 1, and -1
+// otherwise. Unlike is_tautology(), this only looks for a universal cube.
+int cover::constant() const
+{
+	bool null = true;
+	for (int i = 0; i < (int)cubes.size(); i++)
+	{
+		if (cubes[i].is_tautology())
+			return 1;
+		else if (!cubes[i].is_null())
+			null = false;
+	}
+
+	return null ? 0 : -1;
+}
+
 int cover::area() const
 {
 	int result = 0;
@@ -658,18 +700,32 @@ float cover::partition(cover &left, cover &right)
 	return a.weight;
 }
 
-cover &cover::espresso()
+cover &cover::espresso(const espresso_options &options)
 {
-	boolean::espresso(*this, cover(), ~*this);
+	// The off-set of a wide function can be exponentially larger than the
+	// function itself, so those are expanded against the on-set instead.
+	vector<int> support;
+	vars(&support);
+	if ((int)support.size() > truth_table::max_support)
+		boolean::espresso(*this, cover(), options);
+	else
+		boolean::espresso(*this, cover(), ~*this, options);
 	return *this;
 }
 
-cover &cover::minimize()
+// Merge cubes until no pair is mergible. The cubes before first must already
+// be pairwise unmergible, so only the cubes from first onward need to be
+// compared against the rest.
+cover &cover::minimize(int first)
 {
 	for (int i = (int)cubes.size()-1; i >= 0; i--)
 	{
 		if (cubes[i].is_null())
+		{
 			cubes.erase(cubes.begin() + i);
+			if (i < first)
+				first--;
+		}
 		else if (cubes[i].is_tautology())
 		{
 			cubes = vector<cube>(1, cube());
@@ -677,19 +733,21 @@ cover &cover::minimize()
 		}
 	}
 
-	bool done = false;
-	while (!done)
+	// Each new cube absorbs any merged cube it can. Merging may make it
+	// mergible with a cube that was already checked, so the scan restarts
+	// after every merge.
+	for (int clean = first; clean < (int)cubes.size(); clean++)
 	{
-		done = true;
-		for (int i = (int)cubes.size() - 1; i >= 0 ; i--)
-			for (int j = i-1; j >= 0; j--)
-				if (mergible(cubes[i], cubes[j]))
-				{
-					cubes[i].supercube(cubes[j]);
-					cubes.erase(cubes.begin() + j);
-					i--;
-					done = false;
-				}
+		cube c = cubes[clean];
+		for (int j = clean-1; j >= 0; j--)
+			if (mergible(c, cubes[j]))
+			{
+				c.supercube(cubes[j]);
+				cubes.erase(cubes.begin() + j);
+				clean--;
+				j = clean;
+			}
+		cubes[clean] = c;
 	}
 	return *this;
 }
@@ -809,6 +867,48 @@ void cover::apply(const Mapping<int> &m) {
 	}
 }
 
+cover_builder::cover_builder()
+{
+	clean = 0;
+	limit = 128;
+}
+
+cover_builder::~cover_builder()
+{
+}
+
+void cover_builder::reserve(int s)
+{
+	result.reserve(s);
+}
+
+cover_builder &cover_builder::operator|=(const cube &c)
+{
+	result.push_back(c);
+	if (result.size() >= limit)
+		get();
+	return *this;
+}
+
+cover_builder &cover_builder::operator|=(const cover &c)
+{
+	result.cubes.insert(result.cubes.end(), c.cubes.begin(), c.cubes.end());
+	if (result.size() >= limit)
+		get();
+	return *this;
+}
+
+cover &cover_builder::get()
+{
+	if (clean < result.size())
+	{
+		result.minimize(clean);
+		clean = result.size();
+		limit = max(limit, 2*clean);
+	}
+	return result;
+}
+
 ostream &operator<<(ostream &os, cover m)
 {
 	for (int i = 0; i < m.size(); i++)
@@ -819,28 +919,378 @@ ostream &operator<<(ostream &os, cover m)
 	return os;
 }
 
+espresso_options::espresso_options()
+{
+	effort = EFFORT_NORMAL;
+	iterations = -1;
+	budget = -1;
+}
+
+espresso_options::espresso_options(int effort, int iterations, long budget)
+{
+	this->effort = effort;
+	this->iterations = iterations;
+	this->budget = budget;
+}
+
+espresso_options::~espresso_options()
+{
+}
+
+// The rest of the on-set and the don't cares as seen from inside c.
+static cover others(const cover &F, const cover &D, const cube &c)
+{
+	cover result = cofactor(F, c);
+	if (D.size() > 0)
+	{
+		cover dc = cofactor(D, c);
+		result.cubes.insert(result.cubes.end(), dc.cubes.begin(), dc.cubes.end());
+	}
+	return result;
+}
+
+// Expand against the off-set if there is one, otherwise check containment
+// in F+D.
+static void expand_step(cover &F, const cover *R, const cube &always, const cover &FD)
+{
+	if (R != NULL)
+		expand(F, *R, always);
+	else
+		expand_nooffset(F, FD);
+}
+
+// Reduce every cube as far as it goes with the rest of F left alone, then
+// expand the reduced cubes again. For last gasp they are expanded together
+// and only primes covering two or more reduced cubes are kept. For super
+// gasp each one is expanded on its own so every reduced cube contributes a
+// prime. The new primes are added to F, and the result is kept if
+// irredundant makes it cheaper.
+static bool gasp(cover &F, const cover &D, const cover *R, const cube &always, const cover &FD, bool super)
+{
+	cover reduced;
+	for (int i = 0; i < F.size(); i++)
+	{
+		cover rest = F;
+		rest.cubes.erase(rest.cubes.begin()+i);
+		cube r = F[i] & supercube_of_complement(others(rest, D, F[i]));
+		if (!r.is_null() and r != F[i])
+			reduced.push_back(r);
+	}
+
+	if (reduced.size() == 0)
+		return false;
+
+	cover primes;
+	if (super)
+	{
+		for (int i = 0; i < reduced.size(); i++)
+		{
+			cover G(reduced[i]);
+			expand_step(G, R, always, FD);
+			primes.cubes.insert(primes.cubes.end(), G.cubes.begin(), G.cubes.end());
+		}
+	}
+	else
+	{
+		cover G = reduced;
+		expand_step(G, R, always, FD);
+		for (int i = 0; i < G.size(); i++)
+		{
+			int count = 0;
+			for (int j = 0; j < reduced.size() and count < 2; j++)
+				if (reduced[j].is_subset_of(G[i]))
+					count++;
+
+			if (count >= 2)
+				primes.push_back(G[i]);
+		}
+	}
+
+	cover result = F;
+	for (int i = 0; i < primes.size(); i++)
+		if (find(F.begin(), F.end(), primes[i]) == F.end())
+			result.push_back(primes[i]);
+
+	if (result.size() == F.size())
+		return false;
+
+	irredundant(result, D);
+	if (result.area() < F.area())
+	{
+		F = result;
+		return true;
+	}
+	return false;
+}
+
+// The loop shared by both forms of espresso, R is NULL when there is no
+// off-set. The budget is a task under the current one, so cancelling and
+// running out of time both stop it and the result is still a valid cover
+// of F. Once the task is cancelled the complements and containment checks
+// are cut short, so any step that saw the cancel is thrown away rather than
+// kept.
+static void espresso(cover &F, const cover &D, const cover *R, const cover &FD, const espresso_options &options)
+{
+	task limit(current_task(), options.budget);
+	task_scope scope(&limit);
+	if (is_cancelled())
+		return;
+
+	cover original = F;
+	int passes = 0;
+
+	cube always;
+	if (R != NULL)
+	{
+		always = R->supercube();
+		for (int i = 0; i < always.size(); i++)
+			always.values[i] = ~always.values[i];
+	}
+
+	expand_step(F, R, always, FD);
+	irredundant(F, D);
+	if (is_cancelled())
+	{
+		F = original;
+		return;
+	}
+	if (options.effort <= EFFORT_FAST)
+		return;
+
+	cover best = F;
+	int best_cost = F.area();
+	bool done = false;
+	while (!done)
+	{
+		int cost = F.area(), old_cost;
+		do
+		{
+			if ((options.iterations >= 0 and passes >= options.iterations)
+				or is_cancelled())
+			{
+				done = true;
+				break;
+			}
+
+			reduce(F, D);
+			expand_step(F, R, always, FD);
+			irredundant(F, D);
+			if (is_cancelled())
+			{
+				done = true;
+				break;
+			}
+			passes++;
+			report_progress("espresso", passes, options.iterations);
+
+			old_cost = cost;
+			cost = F.area();
+			if (cost < best_cost)
+			{
+				best = F;
+				best_cost = cost;
+			}
+		} while (cost < old_cost);
+
+		if (done or options.effort < EFFORT_STRONG)
+			break;
+
+		F = best;
+		if (is_cancelled())
+			break;
+
+		report_progress("last gasp", 0);
+		if (!gasp(F, D, R, always, FD, false))
+		{
+			report_progress("super gasp", 0);
+			if (!gasp(F, D, R, always, FD, true))
+				break;
+		}
+		if (is_cancelled())
+			break;
+
+		best = F;
+		best_cost = F.area();
+	}
+
+	F = best;
+}
+
 // Run the espresso minimization heuristic algorithm.
 // F refers to the on set
 // D refers to the don't care set
 // R refers to the off set
-void espresso(cover &F, const cover &D, const cover &R)
+void espresso(cover &F, const cover &D, const cover &R, const espresso_options &options)
 {
-	cube always = R.supercube();
-	for (int i = 0; i < always.size(); i++)
-		always.values[i] = ~always.values[i];
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_ESPRESSO, F, D, R, options));
 
-	expand(F, R, always);
-	irredundant(F);
-	int cost = F.area(), old_cost;
-	do
+	espresso(F, D, &R, cover(), options);
+}
+
+// Run espresso without an off-set. Expansion is checked with containment
+// in F+D rather than against R, which never needs the complement.
+void espresso(cover &F, const cover &D, const espresso_options &options)
+{
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_ESPRESSO_NOOFFSET, F, D, options));
+
+	cover FD = F;
+	FD.cubes.insert(FD.cubes.end(), D.cubes.begin(), D.cubes.end());
+	espresso(F, D, NULL, FD, options);
+}
+
+// Update F, a cover previously minimized by espresso, after the cubes of
+// added joined the on-set and the cubes of removed left it. Only the cubes
+// the edit touches are worked on: cubes of F that intersect removed are cut
+// back and re-expanded, cubes of F within distance one of an added cube are
+// re-expanded in case they can now absorb it, and the added cubes are
+// expanded as new ones. Irredundant then only looks at the cubes that
+// overlap those. The rest of F is left alone, so the cost follows the size of
+// the edit rather than the size of F.
+void reminimize(cover &F, const cover &added, const cover &removed, const cover &D)
+{
+	cover outside = removed.is_null() ? cover(1) : ~removed;
+
+	cover result, affected;
+	result.reserve(F.size());
+	for (int i = 0; i < F.size(); i++)
+	{
+		bool cut = false, near = false;
+		for (int j = 0; j < removed.size() and !cut; j++)
+			cut = !are_mutex(F[i], removed[j]);
+		for (int j = 0; j < added.size() and !cut and !near; j++)
+			near = distance(F[i], added[j]) <= 1 and !added[j].is_subset_of(F[i]);
+
+		if (cut)
+		{
+			cover pieces = F[i] & outside;
+			affected.cubes.insert(affected.cubes.end(), pieces.cubes.begin(), pieces.cubes.end());
+		}
+		else if (near)
+			affected.push_back(F[i]);
+		else
+			result.push_back(F[i]);
+	}
+
+	for (int i = 0; i < added.size(); i++)
+	{
+		if (removed.is_null())
+			affected.push_back(added[i]);
+		else
+		{
+			cover pieces = added[i] & outside;
+			affected.cubes.insert(affected.cubes.end(), pieces.cubes.begin(), pieces.cubes.end());
+		}
+	}
+
+	if (affected.size() == 0)
+	{
+		F = result;
+		return;
+	}
+
+	cover FD = result;
+	FD.cubes.insert(FD.cubes.end(), affected.cubes.begin(), affected.cubes.end());
+	FD.cubes.insert(FD.cubes.end(), D.cubes.begin(), D.cubes.end());
+	expand_nooffset(affected, FD);
+
+	// The untouched cubes can only have become redundant if they overlap an
+	// expanded cube. Check the expanded cubes first so that old primes are
+	// preferred when both cover the same minterms.
+	int first = result.size();
+	vector<int> check;
+	for (int i = 0; i < affected.size(); i++)
+		check.push_back(first+i);
+	for (int i = 0; i < first; i++)
+	{
+		bool overlaps = false;
+		for (int j = 0; j < affected.size() and !overlaps; j++)
+			overlaps = !are_mutex(result[i], affected[j]);
+		if (overlaps)
+			check.push_back(i);
+	}
+	result.cubes.insert(result.cubes.end(), affected.cubes.begin(), affected.cubes.end());
+
+	// Only the cubes that intersect a cube can help cover it, so the rest
+	// are left out of its containment check.
+	vector<bool> dropped(result.size(), false);
+	cover rest;
+	for (int i = 0; i < (int)check.size(); i++)
+	{
+		const cube &c = result[check[i]];
+		rest.cubes.clear();
+		for (int j = 0; j < D.size(); j++)
+			if (!are_mutex(c, D[j]))
+				rest.push_back(D[j]);
+		for (int j = 0; j < result.size(); j++)
+			if (j != check[i] and !dropped[j] and !are_mutex(c, result[j]))
+				rest.push_back(result[j]);
+
+		if (c.is_subset_of(rest))
+			dropped[check[i]] = true;
+	}
+
+	F.cubes.clear();
+	for (int i = 0; i < result.size(); i++)
+		if (!dropped[i])
+			F.push_back(result[i]);
+}
+
+// Raise the literals of each cube one at a time, keeping every raise for
+// which the cube stays inside FD. Literals whose opposite shows up in the
+// most other cubes are tried first since raising them covers the most.
+// Cubes contained by an expanded cube are dropped.
+void expand_nooffset(cover &F, const cover &FD)
+{
+	vector<pair<unsigned int, int> > weight = weights(F);
+	sort(weight.begin(), weight.end());
+
+	vector<bool> covered(F.size(), false);
+	vector<int> support;
+	vector<pair<int, int> > order;
+	for (int i = 0; i < (int)weight.size() and !is_cancelled(); i++)
 	{
-		reduce(F);
-		expand(F, R, always);
-		irredundant(F);
+		int c = weight[i].second;
+		if (covered[c])
+			continue;
+
+		support.clear();
+		F[c].vars(&support);
+
+		order.clear();
+		for (int j = 0; j < (int)support.size(); j++)
+		{
+			int val = F[c].get(support[j]);
+			if (val != 0 and val != 1)
+				continue;
+
+			int count = 0;
+			for (int k = 0; k < F.size(); k++)
+				if (F[k].get(support[j]) == 1-val)
+					count++;
+			order.push_back(pair<int, int>(-count, support[j]));
+		}
+		sort(order.begin(), order.end());
+
+		for (int j = 0; j < (int)order.size(); j++)
+		{
+			cube test = F[c];
+			test.set(order[j].second, 2);
+			if (test.is_subset_of(FD))
+				F[c] = test;
+		}
+
+		for (int j = 0; j < F.size(); j++)
+			if (j != c and !covered[j] and F[j].is_subset_of(F[c]))
+				covered[j] = true;
+	}
 
-		old_cost = cost;
-		cost = F.area();
-	} while (cost < old_cost);
+	for (int i = F.size()-1; i >= 0; i--)
+		if (covered[i])
+			F.cubes.erase(F.cubes.begin()+i);
 }
 
 void expand(cover &F, const cover &R, const cube &always)
@@ -848,7 +1298,7 @@ void expand(cover &F, const cover &R, const cube &always)
 	vector<pair<unsigned int, int> > weight = weights(F);
 	sort(weight.begin(), weight.end());
 
-	for (int i = 0; i < (int)weight.size(); i++)
+	for (int i = 0; i < (int)weight.size() and !is_cancelled(); i++)
 	{
 		// TODO any time we expand the cube, we need to mark the newly covered cubes as completely redundant, ignore them throughout the expand step and remove them at the end.
 
@@ -960,9 +1410,19 @@ cube essential(cover &F, const cover &R, int c, const cube &always)
 	return free;
 }
 
+// The cube with every free part raised. free is a mask of parts rather than
+// a cube, so it can't go through supercube(), which treats it as null.
+static cube overexpand(const cube &c, const cube &free)
+{
+	cube result = c;
+	for (int i = 0; i < result.size() and i < free.size(); i++)
+		result.values[i] |= free.values[i];
+	return result;
+}
+
 cube feasible(const cover &F, const cover &R, int c, const cube &free)
 {
-	cube overexpanded = supercube(F[c], free);
+	cube overexpanded = overexpand(F[c], free);
 
 	cover feasibly_covered;
 	feasibly_covered.reserve(F.size()-1);
@@ -1000,7 +1460,7 @@ cube feasible(const cover &F, const cover &R, int c, const cube &free)
 
 bool guided(cover &F, int c, const cube &free)
 {
-	cube overexpanded = supercube(F[c], free);
+	cube overexpanded = overexpand(F[c], free);
 
 	vector<int> covered;
 	covered.reserve(F.size());
@@ -1052,7 +1512,9 @@ bool guided(cover &F, int c, const cube &free)
 		return false;
 }
 
-void reduce(cover &F)
+// Shrink each cube to the smallest cube containing the minterms that no other
+// cube of F or D covers. Cubes covered entirely are removed.
+void reduce(cover &F, const cover &D)
 {
 	static std::mt19937 rng(std::time(nullptr));
 	if (F.cubes.size() > 0)
@@ -1065,11 +1527,11 @@ void reduce(cover &F)
 		for (int i = 0; i < F.size(); i++)
 		{
 			cube s = F[i];
-			F[i] = c & supercube_of_complement(cofactor(F, c));
+			F[i] = c & supercube_of_complement(others(F, D, c));
 			c = s;
 		}
 
-		F.push_back(c & supercube_of_complement(cofactor(F, c)));
+		F.push_back(c & supercube_of_complement(others(F, D, c)));
 	}
 
 	for (int i = F.cubes.size()-1; i >= 0; i--) {
@@ -1079,20 +1541,27 @@ void reduce(cover &F)
 	}
 }
 
-void irredundant(cover &F)
+// Remove the cubes covered by the rest of F together with D.
+void irredundant(cover &F, const cover &D)
 {
-	if (F.cubes.size() > 1)
+	if (F.cubes.size() > 1 or (F.cubes.size() > 0 and D.size() > 0))
 	{
 		cover relatively_essential;
 		vector<int> relatively_redundant;
 		relatively_essential.reserve(F.size());
 		relatively_redundant.reserve(F.size());
 
+		// the don't cares sit after the other F.size()-1 cubes
 		cover test = F;
 		test.pop_back();
+		test.cubes.insert(test.cubes.end(), D.cubes.begin(), D.cubes.end());
 
 		for (int i = F.size()-1; i >= 0; i--)
 		{
+			// the containment checks can't be trusted once cancelled
+			if (is_cancelled())
+				return;
+
 			if (F[i].is_subset_of(test))
 				relatively_redundant.push_back(i);
 			else
@@ -1102,9 +1571,16 @@ void irredundant(cover &F)
 				test[i-1] = F[i];
 		}
 
+		cover kept = D;
+		kept.cubes.insert(kept.cubes.end(), relatively_essential.cubes.begin(), relatively_essential.cubes.end());
 		for (int i = 0; i < (int)relatively_redundant.size(); i++)
-			if (!F[relatively_redundant[i]].is_subset_of(relatively_essential))
+		{
+			if (!F[relatively_redundant[i]].is_subset_of(kept))
+			{
 				relatively_essential.push_back(F[relatively_redundant[i]]);
+				kept.push_back(F[relatively_redundant[i]]);
+			}
+		}
 
 		F = relatively_essential;
 	}
@@ -1277,6 +1753,10 @@ bool vacuous_assign(const cube &encoding, const cover &assignment, bool stable)
 
 cover operator~(cover s1)
 {
+	trace_scope traced;
+	if (traced.outer)
+		trace(trace_record(TRACE_COMPLEMENT, s1));
+
 	// Check for empty function
 	if (s1.is_null())
 		return cover(1);
@@ -1290,6 +1770,9 @@ cover operator~(cover s1)
 	if (s1.size() == 1)
 		return ~s1[0];
 
+	if (is_cancelled())
+		return cover();
+
 	vector<pair<int, int> > binate_rank;
 	for (int i = 0; i < s1.size(); i++)
 	{
@@ -1478,8 +1961,20 @@ cover merge_complement_a2(int uid, const cover &s0, const cover &s1, const cover
 
 cover operator&(cover s1, cover s2)
 {
+	// Skip the product when either side is a constant
+	int c1 = s1.constant(), c2 = s2.constant();
+	if (c1 == 0 or c2 == 0)
+		return cover();
+	else if (c1 == 1)
+		return s2;
+	else if (c2 == 1)
+		return s1;
+
 	cover result;
 	result.reserve(s1.size()*s2.size());
+	// Minimize whenever the result doubles in size so that the total cost of
+	// the intermediate minimizations stays proportional to the last one.
+	int limit = 128, clean = 0;
 	for (int i = 0; i < s1.size(); i++)
 		for (int j = 0; j < s2.size(); j++)
 		{
@@ -1504,11 +1999,15 @@ cover operator&(cover s1, cover s2)
 			else
 				result.pop_back();
 
-			if (result.size() >= 128)
-				result.minimize();
+			if (result.size() >= limit)
+			{
+				result.minimize(clean);
+				clean = result.size();
+				limit = max(limit, 2*clean);
+			}
 		}
 
-	result.minimize();
+	result.minimize(clean);
 
 	return result;
 }
@@ -1588,6 +2087,14 @@ bool are_mutex(const cover &s1, const cover &s2, const cover &s3, const cover &s
 
 cover operator|(cover s1, cover s2)
 {
+	int c1 = s1.constant(), c2 = s2.constant();
+	if (c1 == 1 or c2 == 1)
+		return cover(1);
+	else if (c1 == 0)
+		return s2;
+	else if (c2 == 0)
+		return s1;
+
 	s1.insert(s1.end(), s2.begin(), s2.end());
 	s1.minimize();
 	return s1;
@@ -1623,29 +2130,118 @@ cover operator|(int s1, cover s2)
 		return cover(1);
 }
 
+// The variable with a literal in the most cubes of s1 and s2.
+int split_variable(const cover &s1, const cover &s2)
+{
+	vector<int> count;
+	for (int k = 0; k < 2; k++)
+	{
+		const cover &s = k == 0 ? s1 : s2;
+		for (int i = 0; i < s.size(); i++)
+		{
+			if ((int)count.size() < s[i].size()*16)
+				count.resize(s[i].size()*16, 0);
+			for (int j = 0; j < s[i].size()*16; j++)
+			{
+				int v = s[i].get(j);
+				count[j] += (v == 0 or v == 1);
+			}
+		}
+	}
+	return (int)(max_element(count.begin(), count.end()) - count.begin());
+}
+
+// Recombine the two halves of a Shannon expansion around uid, appending to
+// result. Cubes that appear in both halves are kept without the literal.
+void merge_shannon(int uid, vector<cube> &s0, vector<cube> &s1, vector<cube> &result)
+{
+	sort(s0.begin(), s0.end());
+	sort(s1.begin(), s1.end());
+
+	result.reserve(result.size() + s0.size() + s1.size());
+	int i = 0, j = 0;
+	while (i < (int)s0.size() || j < (int)s1.size())
+	{
+		if (j >= (int)s1.size() || (i < (int)s0.size() && s0[i] < s1[j]))
+		{
+			result.push_back(s0[i++]);
+			result.back().set(uid, 0);
+		}
+		else if (i >= (int)s0.size() || s1[j] < s0[i])
+		{
+			result.push_back(s1[j++]);
+			result.back().set(uid, 1);
+		}
+		else
+		{
+			result.push_back(s0[i]);
+			i++;
+			j++;
+		}
+	}
+}
+
+// s1 ^ s2 ^ invert by Shannon expansion around the variable used by the most
+// cubes. Complements are only taken once one side has been reduced to a
+// constant or both sides to a single cube, so the two full complements of
+// (s1 & ~s2) | (~s1 & s2) are never computed.
+static cover shannon_xor(const cover &s1, const cover &s2, bool invert)
+{
+	int c1 = s1.constant(), c2 = s2.constant();
+	if (c1 >= 0)
+		return (c1 != (int)invert) ? ~s2 : s2;
+	else if (c2 >= 0)
+		return (c2 != (int)invert) ? ~s1 : s1;
+	else if (s1.size() == 1 and s2.size() == 1)
+	{
+		cover n1 = ~s1[0], n2 = ~s2[0];
+		if (invert)
+			return (s1 & s2) | (n1 & n2);
+		return (s1 & n2) | (n1 & s2);
+	}
+	else if (not invert and are_mutex(s1, s2))
+		return s1 | s2;
+
+	int uid = split_variable(s1, s2);
+	cover r0 = shannon_xor(cofactor(s1, uid, 0), cofactor(s2, uid, 0), invert);
+	cover r1 = shannon_xor(cofactor(s1, uid, 1), cofactor(s2, uid, 1), invert);
+	cover result;
+	merge_shannon(uid, r0.cubes, r1.cubes, result.cubes);
+	return result;
+}
+
 cover operator^(cover s1, cover s2)
 {
-	return (s1 & ~s2) | (~s1 & s2);
+	cover result = shannon_xor(s1, s2, false);
+	result.minimize();
+	return result;
 }
 
 cover operator^(cover s1, cube s2)
 {
-	return (s1 & ~s2) | (~s1 & s2);
+	return s1 ^ cover(s2);
 }
 
 cover operator^(cube s1, cover s2)
 {
-	return (s1 & ~s2) | (~s1 & s2);
+	return cover(s1) ^ s2;
 }
 
 cover operator^(cover s1, int s2)
 {
-	return (s1 & ~s2) | (~s1 & s2);
+	return s2 ? ~s1 : s1;
 }
 
 cover operator^(int s1, cover s2)
 {
-	return (s1 & ~s2) | (~s1 & s2);
+	return s1 ? ~s2 : s2;
+}
+
+cover xnor(const cover &s1, const cover &s2)
+{
+	cover result = shannon_xor(s1, s2, true);
+	result.minimize();
+	return result;
 }
 
 cover cofactor(const cover &s1, int uid, int val)
@@ -1719,6 +2315,9 @@ cube supercube_of_complement(const cover &s)
 	if (s.size() == 1)
 		return supercube_of_complement(s[0]);
 
+	if (is_cancelled())
+		return cube();
+
 	vector<pair<int, int> > binate_rank;
 	for (int i = 0; i < s.size(); i++)
 	{
@@ -1773,17 +2372,31 @@ cube supercube_of_complement(const cover &s)
 
 bool operator==(const cover &s1, const cover &s2)
 {
-	return (are_mutex(s1, ~s2) && are_mutex(~s1, s2));
+	vector<int> support;
+	if (small_support(s1, s2, &support))
+		return truth_table(s1, support) == truth_table(s2, support);
+	else if (!small_support(s1, s2, &support, sat::min_support))
+		return sat_are_equal(s1, s2);
+
+	// A complement cut short by a cancel is empty and would be mutex with
+	// anything, so the covers are only equal if neither one saw the cancel.
+	if (!are_mutex(s1, ~s2) or is_cancelled())
+		return false;
+	return are_mutex(~s1, s2) and !is_cancelled();
 }
 
 bool operator==(const cover &s1, const cube &s2)
 {
-	return (are_mutex(s1, ~s2) && are_mutex(~s1, s2));
+	if (!are_mutex(s1, ~s2) or is_cancelled())
+		return false;
+	return are_mutex(~s1, s2) and !is_cancelled();
 }
 
 bool operator==(const cube &s1, const cover &s2)
 {
-	return (are_mutex(s1, ~s2) && are_mutex(~s1, s2));
+	if (!are_mutex(s1, ~s2) or is_cancelled())
+		return false;
+	return are_mutex(~s1, s2) and !is_cancelled();
 }
 
 bool operator==(cover s1, int s2)
@@ -1796,19 +2409,20 @@ bool operator==(int s1, cover s2)
 	return ((s1 == 0 && s2.is_null()) || (s1 == 1 && s2.is_tautology()));
 }
 
+// Shares the fast paths of ==, and is true after a cancel since == is false.
 bool operator!=(const cover &s1, const cover &s2)
 {
-	return (!are_mutex(s1, ~s2) || !are_mutex(~s1, s2));
+	return !(s1 == s2);
 }
 
 bool operator!=(const cover &s1, const cube &s2)
 {
-	return (!are_mutex(s1, ~s2) || !are_mutex(~s1, s2));
+	return !(s1 == s2);
 }
 
 bool operator!=(const cube &s1, const cover &s2)
 {
-	return (!are_mutex(s1, ~s2) || !are_mutex(~s1, s2));
+	return !(s1 == s2);
 }
 
 bool operator!=(cover s1, int s2)
@@ -1877,11 +2491,11 @@ cover weakest_guard(cube term, cover exclusion) {
 }
 
 cover weakest_guard(cover implicant, cover exclusion) {
-	boolean::cover result;
+	boolean::cover_builder result;
 	for (auto c = implicant.begin(); c != implicant.end(); c++) {
 		result |= weaken(*c, exclusion);
 	}
-	return result;
+	return result.get();
 }
 
 }
@@ -21,6 +21,39 @@ using std::iterator;
 
 namespace boolean
 {
+
+// How hard espresso works on a cover.
+enum espresso_effort
+{
+	// A single expand and irredundant pass.
+	EFFORT_FAST = 0,
+	// Reduce, expand and irredundant until the cost stops improving.
+	EFFORT_NORMAL = 1,
+	// The normal loop, then last gasp and super gasp to escape the local
+	// minimum, going back to the loop whenever either finds a better cover.
+	EFFORT_STRONG = 2
+};
+
+struct espresso_options
+{
+	espresso_options();
+	espresso_options(int effort, int iterations = -1, long budget = -1);
+	~espresso_options();
+
+	int effort;
+
+	// The most passes through the reduce, expand, irredundant loop, or -1
+	// for no limit.
+	int iterations;
+
+	// Wall clock budget in microseconds, or -1 for no limit. The iteration
+	// limit is checked between passes, the budget runs out like a cancel
+	// and so is seen inside a pass as well. Once either runs out espresso
+	// stops with the cheapest cover found so far, F itself if the first
+	// expand and irredundant didn't finish.
+	long budget;
+};
+
 struct cover
 {
 	cover();
@@ -50,6 +83,7 @@ struct cover
 	bool is_subset_of(const cover &s) const;
 	bool is_tautology() const;
 	bool is_null() const;
+	int constant() const;
 	int area() const;
 
 	vector<int> vars() const;
@@ -74,8 +108,8 @@ struct cover
 	void cofactor(int uid, int val);
 	float partition(cover &left, cover &right);
 
-	cover &espresso();
-	cover &minimize();
+	cover &espresso(const espresso_options &options = espresso_options());
+	cover &minimize(int first = 0);
 
 	cover &operator=(cover c);
 	cover &operator=(cube c);
@@ -108,18 +142,44 @@ struct cover
 	void apply(const Mapping<int> &m);
 };
 
+// Accumulates the union of many cubes and covers. Additions are appended
+// without merging, and the pending cubes are only merged into the result once
+// they double its size and once more when the result is requested. This
+// produces the same function as a chain of operator|= in linear rather than
+// quadratic time per addition.
+struct cover_builder
+{
+	cover_builder();
+	~cover_builder();
+
+	cover result;
+
+	// result.cubes[0, clean) have already been merged
+	int clean;
+	int limit;
+
+	void reserve(int s);
+	cover_builder &operator|=(const cube &c);
+	cover_builder &operator|=(const cover &c);
+
+	cover &get();
+};
+
 ostream &operator<<(ostream &os, cover m);
 
 // Logic Minimization
-void espresso(cover &F, const cover &D, const cover &R);
+void espresso(cover &F, const cover &D, const cover &R, const espresso_options &options = espresso_options());
+void espresso(cover &F, const cover &D, const espresso_options &options = espresso_options());
+void reminimize(cover &F, const cover &added, const cover &removed, const cover &D = cover());
 pair<int, int> get_cost(cover &F);
 void expand(cover &F, const cover &R, const cube &always);
+void expand_nooffset(cover &F, const cover &FD);
 vector<pair<unsigned int, int> > weights(const cover &F);
 cube essential(cover &F, const cover &R, int c, const cube &always);
 cube feasible(const cover &F, const cover &R, int c, const cube &free);
 bool guided(cover &F, int c, const cube &free);
-void reduce(cover &F);
-void irredundant(cover &F);
+void reduce(cover &F, const cover &D = cover());
+void irredundant(cover &F, const cover &D = cover());
 
 bool mergible(const cover &c1, const cover &c2);
 
@@ -146,6 +206,10 @@ cover operator~(cover s1);
 cover merge_complement_a1(int uid, const cover &s0, const cover &s1, const cover &F);
 cover merge_complement_a2(int uid, const cover &s0, const cover &s1, const cover &F);
 
+// Shannon expansion helpers, shared with esop and truth_table.
+int split_variable(const cover &s1, const cover &s2 = cover());
+void merge_shannon(int uid, vector<cube> &s0, vector<cube> &s1, vector<cube> &result);
+
 cover operator&(cover s1, cover s2);
 cover operator&(cover s1, cube s2);
 cover operator&(cube s1, cover s2);
@@ -168,6 +232,7 @@ cover operator^(cover s1, cube s2);
 cover operator^(cube s1, cover s2);
 cover operator^(cover s1, int s2);
 cover operator^(int s1, cover s2);
+cover xnor(const cover &s1, const cover &s2);
 
 cover cofactor(const cover &s1, const cube &s2);
 cover cofactor(const cover &s1, int uid, int val);
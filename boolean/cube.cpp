@@ -395,6 +395,16 @@ int cube::memory_width() const
 	return 0;
 }
 
+// The number of words up to the last one with a literal in it. The words
+// after that are all tautology, so serialized cubes leave them off.
+int cube::used_words() const
+{
+	int n = size();
+	while (n > 0 and values[n-1] == 0xFFFFFFFF)
+		n--;
+	return n;
+}
+
 // Returns the number of literals in this cube
 int cube::width() const
 {
@@ -66,6 +66,7 @@ struct cube
 	bool is_tautology() const;
 	bool is_null() const;
 	int memory_width() const;
+	int used_words() const;
 	int width() const;
 
 	cube xoutnulls() const;
@@ -0,0 +1,89 @@
+/*
+ * divider.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/divider.h>
+
+namespace boolean
+{
+
+void divide(const bitset &n0, const bitset &n1, bitset *quotient, bitset *remainder, int adder, int policy, int threads)
+{
+	unsigned long a, b;
+	if (n0.to_constant(&a) and n1.to_constant(&b))
+	{
+		if (quotient != NULL)
+			*quotient = from_constant(b == 0 ? ~0ul : a/b, n0.bits.size());
+		if (remainder != NULL)
+			*remainder = from_constant(b == 0 ? a : a%b, n1.bits.size());
+		return;
+	}
+
+	// The partial remainder stays in [-n1, n1), so shifting in the next bit
+	// of the dividend needs two more bits than the divisor to hold the sign.
+	int w = (int)n1.bits.size()+2;
+	bitset divisor = n1;
+	divisor.resize(w);
+	bitset ndivisor = ~divisor;
+
+	// With a zero divisor the partial remainder is just the dividend, which
+	// overflows w bits when n0 is the wider one, so those quotient bits are
+	// forced to one instead.
+	cover zero = 1;
+	for (int j = 0; j < (int)n1.bits.size(); j++)
+		zero = zero & ~n1.bits[j];
+
+	bitset q;
+	q.bits.resize(n0.bits.size(), cover(0));
+
+	bitset r;
+	r.bits.resize(w, cover(0));
+	cover sign = 0;
+	for (int i = (int)n0.bits.size()-1; i >= 0; i--)
+	{
+		r.bits.pop_back();
+		r.bits.insert(r.bits.begin(), n0.bits[i]);
+
+		// subtract the divisor when the remainder is positive and add it when
+		// the remainder is negative
+		cover nsign = ~sign;
+		bitset operand;
+		operand.bits.resize(w);
+		for (int j = 0; j < w; j++)
+			operand.bits[j] = (sign & divisor.bits[j]) | (nsign & ndivisor.bits[j]);
+
+		r = add(r, operand, nsign, adder, threads);
+		r.bits.pop_back();
+		sign = r.bits.back();
+		q.bits[i] = ~sign | zero;
+
+		if (policy == MINIMIZE_EACH_STEP)
+			r.espresso();
+	}
+
+	if (quotient != NULL)
+	{
+		if (policy == MINIMIZE_FINAL)
+			q.espresso();
+		*quotient = q;
+	}
+
+	if (remainder != NULL)
+	{
+		// restore a negative remainder
+		bitset operand;
+		operand.bits.resize(w);
+		for (int j = 0; j < w; j++)
+			operand.bits[j] = sign & divisor.bits[j];
+		r = add(r, operand, cover(0), adder, threads);
+		r.bits.resize(n1.bits.size());
+		if (policy != MINIMIZE_NEVER)
+			r.espresso();
+		*remainder = r;
+	}
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ * divider.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/bitset.h>
+#include <boolean/adder.h>
+
+namespace boolean
+{
+
+// When to run espresso over the partial remainder of a symbolic division.
+enum minimize_policy
+{
+	// Never minimize, the covers grow with every step.
+	MINIMIZE_NEVER = 0,
+	// Minimize the quotient and remainder once they are complete.
+	MINIMIZE_FINAL = 1,
+	// Minimize the partial remainder after every step, the covers stay small
+	// at the cost of one espresso per step.
+	MINIMIZE_EACH_STEP = 2
+};
+
+// Non-restoring division of unsigned n0 by unsigned n1. Each step either
+// adds or subtracts the divisor depending on the sign of the partial
+// remainder, and the sign of the result is the next quotient bit, so there is
+// no separate comparison and no mux of the remainder. The quotient has as
+// many bits as n0 and the remainder as many bits as n1. Dividing by zero
+// gives a quotient of all ones and a remainder of n0 truncated to n1's width.
+void divide(const bitset &n0, const bitset &n1, bitset *quotient, bitset *remainder, int adder = RIPPLE_CARRY, int policy = MINIMIZE_FINAL, int threads = 1);
+
+}
@@ -0,0 +1,335 @@
+/*
+ * esop.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/esop.h>
+#include <boolean/sat.h>
+#include <boolean/truth_table.h>
+
+#include <algorithm>
+#include <bit>
+
+using std::popcount;
+
+namespace boolean
+{
+
+esop::esop()
+{
+}
+
+esop::esop(int val)
+{
+	if (val == 1)
+		cubes.push_back(cube());
+}
+
+esop::esop(int uid, int val)
+{
+	cubes.push_back(cube(uid, val));
+}
+
+esop::esop(cube s)
+{
+	if (not s.is_null())
+		cubes.push_back(s);
+}
+
+// Split s into disjoint cubes by Shannon expansion. Disjoint cubes are both
+// a sum and an exclusive sum of the same function.
+static void disjoint(const cover &s, vector<cube> &result)
+{
+	int c = s.constant();
+	if (c == 0)
+		return;
+	else if (c == 1 or s.size() == 1)
+	{
+		result.push_back(c == 1 ? cube() : s[0]);
+		return;
+	}
+
+	int uid = split_variable(s);
+	vector<cube> s0, s1;
+	disjoint(cofactor(s, uid, 0), s0);
+	disjoint(cofactor(s, uid, 1), s1);
+	merge_shannon(uid, s0, s1, result);
+}
+
+esop::esop(const cover &s)
+{
+	disjoint(s, cubes);
+	exorcism();
+}
+
+esop::~esop()
+{
+}
+
+int esop::size() const
+{
+	return (int)cubes.size();
+}
+
+// The xor of the cubes as a truth table over their support, or false if the
+// support is too wide for one.
+static bool small_table(const vector<cube> &cubes, truth_table *result)
+{
+	vector<int> support;
+	if (!small_support(cover(cubes), cover(), &support))
+		return false;
+
+	*result = truth_table((int)support.size());
+	for (int i = 0; i < (int)cubes.size(); i++)
+		*result ^= truth_table(cover(cubes[i]), support);
+	return true;
+}
+
+// The cover of an esop can be exponentially larger, parity for one, so
+// these are decided on the cubes themselves.
+bool esop::is_null() const
+{
+	truth_table t;
+	if (small_table(cubes, &t))
+		return t.is_null();
+	return sat_xor_is_constant(cubes, 0);
+}
+
+bool esop::is_tautology() const
+{
+	truth_table t;
+	if (small_table(cubes, &t))
+		return t.is_tautology();
+	return sat_xor_is_constant(cubes, 1);
+}
+
+// Remove null cubes and pairs of identical cubes, which cancel.
+esop &esop::cancel()
+{
+	for (int i = (int)cubes.size()-1; i >= 0; i--)
+		if (cubes[i].is_null())
+			cubes.erase(cubes.begin() + i);
+
+	sort(cubes.begin(), cubes.end());
+	int k = 0;
+	for (int i = 0; i < (int)cubes.size(); )
+	{
+		int j = i+1;
+		while (j < (int)cubes.size() and cubes[j] == cubes[i])
+			j++;
+		if ((j-i)%2 == 1)
+			cubes[k++] = cubes[i];
+		i = j;
+	}
+	cubes.resize(k);
+	return *this;
+}
+
+static unsigned int word(const cube &s, int i)
+{
+	return i < s.size() ? s.values[i] : 0xFFFFFFFF;
+}
+
+// The number of variables in which s0 and s1 differ. The first two are
+// stored in uid0 and uid1.
+int esop_distance(const cube &s0, const cube &s1, int *uid0, int *uid1)
+{
+	int result = 0;
+	int m = std::max(s0.size(), s1.size());
+	for (int i = 0; i < m; i++)
+	{
+		unsigned int x = word(s0, i) ^ word(s1, i);
+		x = (x | (x >> 1)) & 0x55555555;
+		while (x != 0)
+		{
+			int uid = i*16 + std::countr_zero(x)/2;
+			if (result == 0 and uid0 != NULL)
+				*uid0 = uid;
+			else if (result == 1 and uid1 != NULL)
+				*uid1 = uid;
+			result++;
+			x &= x-1;
+		}
+	}
+	return result;
+}
+
+// The literals of a variable are sets of values {0}, {1}, or {0,1}, and the
+// xor of two literals is the symmetric difference of their sets, which is
+// the xor of their encodings.
+static void exor_literal(cube &s, const cube &s0, const cube &s1, int uid)
+{
+	s.set(uid, ((s0.get(uid)+1) ^ (s1.get(uid)+1)) - 1);
+}
+
+// An EXORCISM style minimizer. Pairs of cubes at distance 0 cancel and pairs
+// at distance 1 merge into a single cube. When no such pair is left, a pair
+// at distance 2 is rewritten with exorlink into another equivalent pair if
+// that has fewer literals or brings one of the new cubes within distance 1
+// of a third cube. Every pass reduces either the number of cubes or the
+// number of literals, so this terminates.
+esop &esop::exorcism()
+{
+	cancel();
+
+	bool progress = true;
+	while (progress)
+	{
+		progress = false;
+		for (int i = (int)cubes.size()-1; i >= 0 and not progress; i--)
+			for (int j = i-1; j >= 0 and not progress; j--)
+			{
+				int uid0 = -1;
+				int d = esop_distance(cubes[i], cubes[j], &uid0, NULL);
+				if (d == 0)
+				{
+					cubes.erase(cubes.begin() + i);
+					cubes.erase(cubes.begin() + j);
+					progress = true;
+				}
+				else if (d == 1)
+				{
+					exor_literal(cubes[j], cubes[i], cubes[j], uid0);
+					cubes.erase(cubes.begin() + i);
+					progress = true;
+				}
+			}
+
+		for (int i = (int)cubes.size()-1; i >= 0 and not progress; i--)
+			for (int j = i-1; j >= 0 and not progress; j--)
+			{
+				int uid0 = -1, uid1 = -1;
+				if (esop_distance(cubes[i], cubes[j], &uid0, &uid1) != 2)
+					continue;
+
+				for (int option = 0; option < 2 and not progress; option++)
+				{
+					// a0 a1 ^ b0 b1 = (a0^b0) a1 ^ b0 (a1^b1)
+					//               = a0 (a1^b1) ^ (a0^b0) b1
+					const cube &a = cubes[i], &b = cubes[j];
+					cube n0 = a, n1 = b;
+					exor_literal(n0, a, b, option == 0 ? uid0 : uid1);
+					exor_literal(n1, a, b, option == 0 ? uid1 : uid0);
+
+					progress = n0.width() + n1.width() < a.width() + b.width();
+					for (int k = 0; k < (int)cubes.size() and not progress; k++)
+						progress = k != i and k != j and (esop_distance(n0, cubes[k], NULL, NULL) <= 1 or esop_distance(n1, cubes[k], NULL, NULL) <= 1);
+
+					if (progress)
+					{
+						cubes[i] = n0;
+						cubes[j] = n1;
+					}
+				}
+			}
+	}
+
+	return *this;
+}
+
+// Pairwise xor of the cubes as covers, see operator^(cover, cover).
+cover esop::to_cover() const
+{
+	vector<cover> level;
+	level.reserve(cubes.size());
+	for (int i = 0; i < (int)cubes.size(); i++)
+		level.push_back(cover(cubes[i]));
+
+	if (level.empty())
+		return cover();
+
+	while (level.size() > 1)
+	{
+		vector<cover> next;
+		next.reserve((level.size()+1)/2);
+		for (int i = 0; i+1 < (int)level.size(); i += 2)
+			next.push_back(level[i] ^ level[i+1]);
+		if (level.size()%2 == 1)
+			next.push_back(level.back());
+		level.swap(next);
+	}
+	return level[0];
+}
+
+esop &esop::operator^=(const esop &e)
+{
+	cubes.insert(cubes.end(), e.cubes.begin(), e.cubes.end());
+	return cancel();
+}
+
+esop &esop::operator&=(const esop &e)
+{
+	*this = *this & e;
+	return *this;
+}
+
+esop &esop::operator|=(const esop &e)
+{
+	*this = *this | e;
+	return *this;
+}
+
+ostream &operator<<(ostream &os, const esop &e)
+{
+	for (int i = 0; i < e.size(); i++)
+		os << (i > 0 ? "^ " : "") << e.cubes[i] << " ";
+	if (e.size() == 0)
+		os << "0";
+
+	return os;
+}
+
+esop operator~(const esop &e)
+{
+	return e ^ esop(1);
+}
+
+esop operator^(const esop &e0, const esop &e1)
+{
+	esop result = e0;
+	result ^= e1;
+	return result;
+}
+
+// And distributes over xor
+esop operator&(const esop &e0, const esop &e1)
+{
+	esop result;
+	result.cubes.reserve(e0.size()*e1.size());
+	for (int i = 0; i < e0.size(); i++)
+		for (int j = 0; j < e1.size(); j++)
+		{
+			cube s = e0.cubes[i] & e1.cubes[j];
+			if (not s.is_null())
+				result.cubes.push_back(s);
+		}
+	return result.cancel();
+}
+
+// a | b = a ^ b ^ (a & b)
+esop operator|(const esop &e0, const esop &e1)
+{
+	esop result = e0 ^ e1;
+	result ^= e0 & e1;
+	return result;
+}
+
+esop cofactor(const esop &e, int uid, int val)
+{
+	esop result;
+	result.cubes.reserve(e.size());
+	for (int i = 0; i < e.size(); i++)
+	{
+		int cmp = e.cubes[i].get(uid);
+		if (cmp != 1-val and cmp != -1)
+		{
+			result.cubes.push_back(e.cubes[i]);
+			result.cubes.back().set(uid, 2);
+		}
+	}
+	return result.cancel();
+}
+
+}
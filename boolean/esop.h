@@ -0,0 +1,54 @@
+/*
+ * esop.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+namespace boolean
+{
+
+// An exclusive sum of products, the xor of its cubes. Parity and sum bits
+// that need an exponential number of cubes as a cover only need a linear
+// number here, so XOR heavy logic can stay in this form and be converted to
+// a cover once at the end.
+struct esop
+{
+	esop();
+	esop(int val);
+	esop(int uid, int val);
+	esop(cube s);
+	esop(const cover &s);
+	~esop();
+
+	vector<cube> cubes;
+
+	int size() const;
+	bool is_null() const;
+	bool is_tautology() const;
+
+	esop &cancel();
+	esop &exorcism();
+	cover to_cover() const;
+
+	esop &operator^=(const esop &e);
+	esop &operator&=(const esop &e);
+	esop &operator|=(const esop &e);
+};
+
+ostream &operator<<(ostream &os, const esop &e);
+
+int esop_distance(const cube &s0, const cube &s1, int *uid0, int *uid1);
+
+esop operator~(const esop &e);
+esop operator^(const esop &e0, const esop &e1);
+esop operator&(const esop &e0, const esop &e1);
+esop operator|(const esop &e0, const esop &e1);
+
+esop cofactor(const esop &e, int uid, int val);
+
+}
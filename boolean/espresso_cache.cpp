@@ -0,0 +1,334 @@
+/*
+ * espresso_cache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/espresso_cache.h>
+#include <boolean/truth_table.h>
+#include <boolean/hash.h>
+#include <boolean/task.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boolean
+{
+
+const uint64_t espresso_cache::magic;
+const uint32_t espresso_cache::version;
+
+static uint64_t load(const uint64_t *value)
+{
+	return std::atomic_ref<uint64_t>(*const_cast<uint64_t*>(value)).load(std::memory_order_acquire);
+}
+
+static void store(uint64_t *value, uint64_t to)
+{
+	std::atomic_ref<uint64_t>(*value).store(to, std::memory_order_release);
+}
+
+// Hash the problem twice with independent seeds. The cubes are sorted first
+// so that the order they were listed in doesn't matter.
+espresso_cache::problem_key espresso_cache::key(const cover &F, const cover &D, const espresso_options &options)
+{
+	vector<cube> f = F.cubes, d = D.cubes;
+	sort(f.begin(), f.end());
+	sort(d.begin(), d.end());
+
+	hasher h[2] = {hasher(0), hasher(0x2545F4914F6CDD1Dull)};
+	for (int i = 0; i < 2; i++) {
+		h[i].put(&f);
+		h[i].put(&d);
+		h[i].put((uint64_t)options.effort);
+		h[i].put((uint64_t)(int64_t)options.iterations);
+		h[i].put((uint64_t)(int64_t)options.budget);
+	}
+
+	problem_key result;
+	result.key = h[0].get();
+	result.check = h[1].get();
+	return result;
+}
+
+espresso_cache::espresso_cache()
+{
+	fd = -1;
+	data = NULL;
+	size = 0;
+}
+
+espresso_cache::~espresso_cache()
+{
+	close();
+}
+
+espresso_cache::header *espresso_cache::head() const
+{
+	return (header*)data;
+}
+
+uint64_t *espresso_cache::slots() const
+{
+	return (uint64_t*)(data + sizeof(header));
+}
+
+// The record at offset, or NULL if it doesn't lie entirely within the
+// record area. Nothing read from the file is trusted.
+const espresso_cache::record *espresso_cache::at(uint64_t offset) const
+{
+	uint64_t first = sizeof(header) + (uint64_t)head()->slots*sizeof(uint64_t);
+	if (offset < first or offset % 8 != 0 or offset > size or size - offset < sizeof(record))
+		return NULL;
+
+	const record *r = (const record*)(data + offset);
+	if (r->length > size - offset - sizeof(record))
+		return NULL;
+	return r;
+}
+
+bool espresso_cache::open(const char *path, size_t capacity)
+{
+	close();
+
+	fd = ::open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+		return false;
+
+	// only one process may initialize a new file
+	flock(fd, LOCK_EX);
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		flock(fd, LOCK_UN);
+		close();
+		return false;
+	}
+
+	bool fresh = (st.st_size == 0);
+	if (fresh) {
+		capacity = std::max(capacity, (size_t)4096);
+		if (ftruncate(fd, capacity) != 0) {
+			flock(fd, LOCK_UN);
+			close();
+			return false;
+		}
+		size = capacity;
+	} else
+		size = st.st_size;
+
+	data = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED) {
+		data = NULL;
+		flock(fd, LOCK_UN);
+		close();
+		return false;
+	}
+
+	if (fresh) {
+		// about one slot per 256 bytes of records
+		uint32_t n = 16;
+		while ((uint64_t)n*2*256 <= size)
+			n *= 2;
+
+		header *h = head();
+		h->magic = magic;
+		h->version = version;
+		h->slots = n;
+		h->capacity = size;
+		h->end = sizeof(header) + (uint64_t)n*sizeof(uint64_t);
+		msync(data, sizeof(header), MS_SYNC);
+	}
+	flock(fd, LOCK_UN);
+
+	// the slot count must be a power of two for the probe mask, and the
+	// record area must start after the table and end within the file
+	header *h = head();
+	if (size < sizeof(header) or h->magic != magic or h->version != version
+		or h->capacity != size or h->slots == 0 or (h->slots & (h->slots-1)) != 0
+		or sizeof(header) + (uint64_t)h->slots*sizeof(uint64_t) > size
+		or h->end < sizeof(header) + (uint64_t)h->slots*sizeof(uint64_t) or h->end > size) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void espresso_cache::close()
+{
+	if (data != NULL)
+		munmap(data, size);
+	if (fd >= 0)
+		::close(fd);
+	fd = -1;
+	data = NULL;
+	size = 0;
+}
+
+bool espresso_cache::is_open() const
+{
+	return data != NULL;
+}
+
+bool espresso_cache::find(const cover &F, const cover &D, const espresso_options &options, cover *result) const
+{
+	if (data == NULL)
+		return false;
+	return find(key(F, D, options), result);
+}
+
+bool espresso_cache::find(problem_key k, cover *result) const
+{
+	if (data == NULL)
+		return false;
+
+	uint32_t mask = head()->slots-1;
+	uint64_t *table = slots();
+	for (uint32_t i = 0, s = (uint32_t)k.key & mask; i <= mask; i++, s = (s+1) & mask) {
+		uint64_t offset = load(table + s);
+		if (offset == 0)
+			return false;
+
+		const record *r = at(offset);
+		if (r == NULL)
+			return false;
+		if (r->key != k.key or r->check != k.check)
+			continue;
+
+		// every count is checked against the length of the record
+		const uint32_t *word = (const uint32_t*)(r+1);
+		const uint32_t *end = word + r->length/sizeof(uint32_t);
+		if (word == end)
+			return false;
+		uint32_t cubes = *word++;
+		if (cubes > (uint64_t)(end - word))
+			return false;
+
+		result->cubes.clear();
+		result->cubes.resize(cubes);
+		for (uint32_t j = 0; j < cubes; j++) {
+			if (word == end or *word > (uint64_t)(end - word - 1)) {
+				result->cubes.clear();
+				return false;
+			}
+			uint32_t n = *word++;
+			result->cubes[j].values.assign(word, word+n);
+			word += n;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool espresso_cache::insert(const cover &F, const cover &D, const espresso_options &options, const cover &result)
+{
+	if (data == NULL)
+		return false;
+	return insert(key(F, D, options), result);
+}
+
+bool espresso_cache::insert(problem_key k, const cover &result)
+{
+	if (data == NULL)
+		return false;
+
+	uint64_t length = 1;
+	for (int i = 0; i < result.size(); i++)
+		length += 1 + result[i].used_words();
+	length *= sizeof(uint32_t);
+	uint64_t total = (sizeof(record) + length + 7) & ~(uint64_t)7;
+
+	std::lock_guard<std::mutex> guard(writer);
+	flock(fd, LOCK_EX);
+
+	header *h = head();
+	uint32_t mask = h->slots-1;
+	uint64_t *table = slots();
+	uint64_t end = load(&h->end);
+	bool stored = false;
+	if (end >= sizeof(header) + (uint64_t)h->slots*sizeof(uint64_t) and end <= size and total <= size - end) {
+		for (uint32_t i = 0, s = (uint32_t)k.key & mask; i <= mask; i++, s = (s+1) & mask) {
+			uint64_t offset = load(table + s);
+			if (offset != 0) {
+				const record *r = at(offset);
+				if (r == NULL or (r->key == k.key and r->check == k.check))
+					break;
+				continue;
+			}
+
+			record *r = (record*)(data + end);
+			r->key = k.key;
+			r->check = k.check;
+			r->length = length;
+
+			uint32_t *word = (uint32_t*)(r+1);
+			*word++ = (uint32_t)result.size();
+			for (int j = 0; j < result.size(); j++) {
+				int n = result[j].used_words();
+				*word++ = (uint32_t)n;
+				memcpy(word, result[j].values.data(), n*sizeof(uint32_t));
+				word += n;
+			}
+
+			store(&h->end, end + total);
+			store(table + s, end);
+			stored = true;
+			break;
+		}
+	}
+
+	flock(fd, LOCK_UN);
+	return stored;
+}
+
+int espresso_cache::count() const
+{
+	if (data == NULL)
+		return 0;
+
+	int result = 0;
+	uint64_t *table = slots();
+	for (uint32_t i = 0; i < head()->slots; i++)
+		if (load(table + i) != 0)
+			result++;
+	return result;
+}
+
+void espresso(cover &F, const cover &D, espresso_cache &cache, const espresso_options &options)
+{
+	espresso_cache::problem_key k = espresso_cache::key(F, D, options);
+
+	cover result;
+	if (cache.find(k, &result)) {
+		F = result;
+		return;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	cover original = F;
+	vector<int> support;
+	F.vars(&support);
+	D.vars(&support);
+	sort(support.begin(), support.end());
+	support.resize(unique(support.begin(), support.end()) - support.begin());
+	if ((int)support.size() > truth_table::max_support)
+		espresso(F, D, options);
+	else
+		espresso(F, D, ~(original | D), options);
+
+	// a run cut short by a cancel or the budget is still a valid cover, but
+	// another run of the same problem could do better so it isn't kept
+	long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	if (!is_cancelled() and (options.budget < 0 or elapsed < options.budget))
+		cache.insert(k, F);
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * espresso_cache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+#include <mutex>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace boolean
+{
+
+// A persistent cache of espresso results in a memory mapped file, so the
+// same minimization problems can be shared across runs and processes.
+// Entries are keyed on a hash of the cubes of F and D in sorted order along
+// with the espresso options, and checked against a second independent hash
+// on lookup.
+//
+// The file is a header, a table of slots and an append-only record area.
+// Records are written in full before the slot pointing at them is published
+// with a single atomic store, so lookups never take a lock. Writers are
+// serialized with a mutex within the process and flock() across processes.
+// The file never grows: once the table or the record area is full, new
+// results are simply not stored.
+struct espresso_cache
+{
+	espresso_cache();
+	~espresso_cache();
+
+	static const uint64_t magic = 0x4F53455250534542ull;
+	static const uint32_t version = 1;
+
+	struct header
+	{
+		uint64_t magic;
+		uint32_t version;
+		uint32_t slots;
+		uint64_t capacity;
+		// The first free byte of the record area.
+		uint64_t end;
+	};
+
+	int fd;
+	char *data;
+	size_t size;
+	std::mutex writer;
+
+	// Open or create the cache at path. A new file is created with capacity
+	// bytes, an existing one keeps its own size.
+	bool open(const char *path, size_t capacity = 64ul << 20);
+	void close();
+	bool is_open() const;
+
+	// The two hashes a problem is stored under, computed in one pass so a
+	// lookup followed by an insert only has to sort the cubes once.
+	struct problem_key
+	{
+		uint64_t key;
+		uint64_t check;
+	};
+
+	static problem_key key(const cover &F, const cover &D, const espresso_options &options);
+
+	bool find(const cover &F, const cover &D, const espresso_options &options, cover *result) const;
+	bool find(problem_key k, cover *result) const;
+	bool insert(const cover &F, const cover &D, const espresso_options &options, const cover &result);
+	bool insert(problem_key k, const cover &result);
+
+	int count() const;
+
+private:
+	// A record in the record area, followed by the cover as a cube count and
+	// then each cube as a word count and its words.
+	struct record
+	{
+		uint64_t key;
+		uint64_t check;
+		uint64_t length;
+	};
+
+	header *head() const;
+	uint64_t *slots() const;
+	const record *at(uint64_t offset) const;
+};
+
+// Minimize F through the cache. On a hit F is replaced by the stored result
+// and espresso doesn't run, otherwise the result is stored for next time
+// unless the run was cut short by a cancel or by running out of budget.
+void espresso(cover &F, const cover &D, espresso_cache &cache, const espresso_options &options = espresso_options());
+
+}
@@ -0,0 +1,234 @@
+/*
+ * expression.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/expression.h>
+
+namespace boolean
+{
+
+variable_table::variable_table()
+{
+}
+
+variable_table::~variable_table()
+{
+}
+
+// Look the name up first so that a hit never copies it into a new key.
+int variable_table::define(const string &name)
+{
+	auto found = uids.find(name);
+	if (found != uids.end())
+		return found->second;
+
+	int uid = (int)names.size();
+	uids.insert(pair<string, int>(name, uid));
+	names.push_back(name);
+	return uid;
+}
+
+int variable_table::find(const string &name) const
+{
+	auto result = uids.find(name);
+	return result == uids.end() ? -1 : result->second;
+}
+
+struct parser
+{
+	const char *i;
+	const char *end;
+	variable_table &vars;
+	bool define;
+
+	// reused so that looking up a name doesn't allocate
+	string name;
+
+	parser(const char *i, const char *end, variable_table &vars, bool define) : i(i), end(end), vars(vars), define(define) {}
+
+	void skip()
+	{
+		while (i < end and (*i == ' ' or *i == '\t' or *i == '\r'))
+			i++;
+	}
+};
+
+static bool is_name(char c)
+{
+	return c != ' ' and c != '\t' and c != '\r' and c != '\n' and c != '&' and c != '|'
+		and c != '~' and c != '!' and c != '(' and c != ')';
+}
+
+static bool parse_or(parser &p, vector<cube> *result);
+
+// A product of factors. Literals are written straight into the cubes of the
+// product, and only parenthesized factors need a cross product.
+static bool parse_and(parser &p, vector<cube> *result)
+{
+	vector<cube> product(1, cube());
+	while (true) {
+		p.skip();
+		bool negate = false;
+		while (p.i < p.end and (*p.i == '~' or *p.i == '!')) {
+			negate = !negate;
+			p.i++;
+			p.skip();
+		}
+
+		if (p.i < p.end and *p.i == '(') {
+			p.i++;
+			vector<cube> sub;
+			if (!parse_or(p, &sub))
+				return false;
+			p.skip();
+			if (p.i >= p.end or *p.i != ')')
+				return false;
+			p.i++;
+
+			if (negate) {
+				cover c(sub);
+				c.minimize();
+				sub = (~c).cubes;
+			}
+
+			vector<cube> next;
+			next.reserve(product.size()*sub.size());
+			for (int j = 0; j < (int)product.size(); j++)
+				for (int k = 0; k < (int)sub.size(); k++) {
+					cube c = product[j] & sub[k];
+					if (!c.is_null())
+						next.push_back(c);
+				}
+			product.swap(next);
+		} else {
+			const char *start = p.i;
+			while (p.i < p.end and is_name(*p.i))
+				p.i++;
+			if (p.i == start)
+				return false;
+
+			if (p.i - start == 1 and (*start == '0' or *start == '1')) {
+				if ((*start == '0') != negate)
+					product.clear();
+			} else {
+				p.name.assign(start, p.i);
+				int uid = p.define ? p.vars.define(p.name) : p.vars.find(p.name);
+				if (uid < 0)
+					return false;
+
+				int w = uid/16;
+				unsigned int m = (negate ? 2u : 1u) << (2*(uid%16));
+				for (int j = 0; j < (int)product.size(); j++) {
+					if (product[j].size() <= w)
+						product[j].extendX(w + 1 - product[j].size());
+					product[j].values[w] &= ~m;
+				}
+			}
+		}
+
+		p.skip();
+		if (p.i >= p.end or *p.i != '&')
+			break;
+		p.i++;
+	}
+
+	result->insert(result->end(), product.begin(), product.end());
+	return true;
+}
+
+static bool parse_or(parser &p, vector<cube> *result)
+{
+	if (!parse_and(p, result))
+		return false;
+
+	p.skip();
+	while (p.i < p.end and *p.i == '|') {
+		p.i++;
+		if (!parse_and(p, result))
+			return false;
+		p.skip();
+	}
+	return true;
+}
+
+bool parse_expression(const char *data, size_t length, variable_table &vars, cover *result, bool define)
+{
+	parser p(data, data + length, vars, define);
+	result->cubes.clear();
+	if (!parse_or(p, &result->cubes))
+		return false;
+
+	p.skip();
+	if (p.i != p.end)
+		return false;
+
+	result->minimize();
+	return true;
+}
+
+bool parse_expression(const string &expr, variable_table &vars, cover *result, bool define)
+{
+	return parse_expression(expr.data(), expr.size(), vars, result, define);
+}
+
+bool parse_expressions(const char *data, size_t length, variable_table &vars, vector<cover> *result, bool define)
+{
+	const char *i = data, *end = data + length;
+	while (i < end) {
+		const char *line = i;
+		while (i < end and *i != '\n')
+			i++;
+		const char *next = i < end ? i+1 : i;
+
+		while (line < i and (*line == ' ' or *line == '\t' or *line == '\r'))
+			line++;
+		if (line < i and *line != '#') {
+			cover c;
+			if (!parse_expression(line, i - line, vars, &c, define))
+				return false;
+			result->push_back(c);
+		}
+		i = next;
+	}
+	return true;
+}
+
+string format_expression(const cover &c, const variable_table &vars)
+{
+	string result;
+	for (int i = 0; i < c.size(); i++) {
+		if (c[i].is_null())
+			continue;
+
+		if (!result.empty())
+			result += "|";
+
+		bool first = true;
+		for (int uid = 0; uid < c[i].size()*16; uid++) {
+			int val = c[i].get(uid);
+			if (val == 2)
+				continue;
+
+			if (!first)
+				result += "&";
+			if (val == 0)
+				result += "~";
+			if (uid < (int)vars.names.size())
+				result += vars.names[uid];
+			else
+				result += "v" + std::to_string(uid);
+			first = false;
+		}
+		if (first)
+			result += "1";
+	}
+
+	if (result.empty())
+		result = "0";
+	return result;
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * expression.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+
+using std::string;
+using std::unordered_map;
+
+namespace boolean
+{
+
+// Maps variable names onto uids and back.
+struct variable_table
+{
+	variable_table();
+	~variable_table();
+
+	unordered_map<string, int> uids;
+	vector<string> names;
+
+	// Returns the uid of a name, giving it the next free uid if it doesn't
+	// have one yet.
+	int define(const string &name);
+
+	// Returns the uid of a name, or -1 if it isn't in the table.
+	int find(const string &name) const;
+};
+
+// Parse an expression like "a&~b|(c|~d)&e" straight into the cubes of a
+// cover. ~ and ! negate, & binds tighter than |, and 0 and 1 are the
+// constants. Names are looked up in the table, and when define is set any
+// name that isn't there yet is added to it. The cover is only minimized once
+// at the end rather than after every |. Returns false if the expression is
+// malformed or uses a name the table doesn't have.
+bool parse_expression(const char *data, size_t length, variable_table &vars, cover *result, bool define = true);
+bool parse_expression(const string &expr, variable_table &vars, cover *result, bool define = true);
+
+// Parse one expression per line, skipping blank lines and lines starting
+// with #. Returns false on the first line that doesn't parse, leaving the
+// covers of the lines before it in result.
+bool parse_expressions(const char *data, size_t length, variable_table &vars, vector<cover> *result, bool define = true);
+
+// Format a cover as a sum of products using the names in the table. Variables
+// without a name are written as v<uid>.
+string format_expression(const cover &c, const variable_table &vars);
+
+}
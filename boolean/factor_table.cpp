@@ -0,0 +1,130 @@
+/*
+ * factor_table.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/factor_table.h>
+#include <boolean/hash.h>
+
+namespace boolean
+{
+
+factor_table::factor_table()
+{
+}
+
+factor_table::~factor_table()
+{
+}
+
+int factor_table::size() const
+{
+	return (int)factors.size();
+}
+
+void factor_table::clear()
+{
+	factors.clear();
+	hashes.clear();
+	slots.clear();
+}
+
+// Compare two cubes for equality, treating missing words as tautologies.
+// This is operator==() without the copies.
+static bool same(const cube &s0, const cube &s1)
+{
+	int m = std::min(s0.size(), s1.size());
+	int i = 0;
+	for (; i < m; i++)
+		if (s0.values[i] != s1.values[i])
+			return false;
+	for (; i < s0.size(); i++)
+		if (s0.values[i] != 0xFFFFFFFF)
+			return false;
+	for (; i < s1.size(); i++)
+		if (s1.values[i] != 0xFFFFFFFF)
+			return false;
+	return true;
+}
+
+// Returns the slot that either holds c or is the empty slot where c belongs.
+int factor_table::probe(const cube &c, uint64_t h) const
+{
+	int mask = (int)slots.size()-1;
+	int i = (int)(h & (uint64_t)mask);
+	while (slots[i] != 0) {
+		int pos = slots[i]-1;
+		if (hashes[pos] == h and same(factors[pos], c))
+			return i;
+		i = (i+1) & mask;
+	}
+	return i;
+}
+
+void factor_table::rehash(int capacity)
+{
+	slots.assign(capacity, 0);
+	int mask = capacity-1;
+	for (int pos = 0; pos < (int)factors.size(); pos++) {
+		int i = (int)(hashes[pos] & (uint64_t)mask);
+		while (slots[i] != 0)
+			i = (i+1) & mask;
+		slots[i] = pos+1;
+	}
+}
+
+// Returns the position of c in the table or -1 if it isn't there.
+int factor_table::find(const cube &c) const
+{
+	if (slots.empty())
+		return -1;
+
+	int i = probe(c, hash(c));
+	return slots[i]-1;
+}
+
+// Returns the position of c in the table, inserting it at the end if it
+// isn't there.
+int factor_table::insert(const cube &c)
+{
+	// keep the load factor at or below one half
+	if (2*((int)factors.size()+1) > (int)slots.size())
+		rehash(slots.empty() ? 16 : 2*(int)slots.size());
+
+	uint64_t h = hash(c);
+	int i = probe(c, h);
+	if (slots[i] == 0) {
+		factors.push_back(c);
+		hashes.push_back(h);
+		slots[i] = (int)factors.size();
+	}
+	return slots[i]-1;
+}
+
+map<cube, int> factor_table::to_map(int offset) const
+{
+	map<cube, int> result;
+	for (int i = 0; i < (int)factors.size(); i++)
+		result.insert(pair<cube, int>(factors[i], offset+i));
+	return result;
+}
+
+int factor_index(factor_table &factors, const cube &c, int offset)
+{
+	return offset + factors.insert(c);
+}
+
+int factor_index(map<cube, int> &factors, const cube &c, int offset)
+{
+	map<cube, int>::iterator loc = factors.find(c);
+	if (loc == factors.end()) {
+		int index = offset + factors.size();
+		factors.insert(pair<cube, int>(c, index));
+		return index;
+	}
+	return loc->second;
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * factor_table.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cube.h>
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+using std::vector;
+using std::map;
+
+namespace boolean
+{
+
+// The table of common factors found by the decomposition routines. Each
+// distinct cube is given the position at which it was first inserted, which
+// never changes. Lookups go through an open-addressing hash table keyed on
+// the cube hash rather than cube ordering.
+struct factor_table
+{
+	factor_table();
+	~factor_table();
+
+	// The factors in insertion order, factors[i] has position i.
+	vector<cube> factors;
+	vector<uint64_t> hashes;
+
+	// Linear probing table of positions into factors, offset by one so that
+	// zero marks an empty slot. Its size is always a power of two.
+	vector<int> slots;
+
+	int size() const;
+	void clear();
+
+	int find(const cube &c) const;
+	int insert(const cube &c);
+
+	map<cube, int> to_map(int offset = 0) const;
+
+private:
+	int probe(const cube &c, uint64_t h) const;
+	void rehash(int capacity);
+};
+
+// Get the variable index for a factor, adding the factor to the table if it
+// isn't already there. New factors are numbered sequentially from offset.
+int factor_index(factor_table &factors, const cube &c, int offset);
+int factor_index(map<cube, int> &factors, const cube &c, int offset);
+
+}
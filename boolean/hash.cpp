@@ -0,0 +1,81 @@
+/*
+ * hash.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/hash.h>
+#include <boolean/cover.h>
+
+namespace boolean
+{
+
+hasher::hasher()
+{
+	state = 0x9E3779B97F4A7C15ull;
+}
+
+hasher::hasher(uint64_t seed)
+{
+	state = seed ^ 0x9E3779B97F4A7C15ull;
+}
+
+hasher::~hasher()
+{
+}
+
+void hasher::put(uint64_t value)
+{
+	// multiply-xorshift mixing step, see splitmix64
+	state ^= value + 0x9E3779B97F4A7C15ull + (state << 6) + (state >> 2);
+	state *= 0xBF58476D1CE4E5B9ull;
+	state ^= state >> 31;
+}
+
+void hasher::put(const vector<unsigned int> *values)
+{
+	put(values->data(), (int)values->size());
+}
+
+// The words of a cube stored somewhere other than a cube, hashed the same
+// way the cube would be.
+void hasher::put(const unsigned int *values, int n)
+{
+	while (n > 0 and values[n-1] == 0xFFFFFFFF)
+		n--;
+
+	int i = 0;
+	for (; i+1 < n; i += 2)
+		put(((uint64_t)values[i+1] << 32) | (uint64_t)values[i]);
+	if (i < n)
+		put(0xFFFFFFFF00000000ull | (uint64_t)values[i]);
+	put((uint64_t)n);
+}
+
+void hasher::put(const vector<cube> *cubes)
+{
+	for (int i = 0; i < (int)cubes->size(); i++)
+		(*cubes)[i].hash(*this);
+	put((uint64_t)cubes->size());
+}
+
+uint64_t hasher::get() const
+{
+	uint64_t result = state;
+	result ^= result >> 30;
+	result *= 0xBF58476D1CE4E5B9ull;
+	result ^= result >> 27;
+	result *= 0x94D049BB133111EBull;
+	result ^= result >> 31;
+	return result;
+}
+
+uint64_t hash(const cube &c)
+{
+	hasher result;
+	c.hash(result);
+	return result.get();
+}
+
+}
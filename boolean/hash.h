@@ -0,0 +1,41 @@
+/*
+ * hash.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cube.h>
+
+#include <vector>
+#include <stdint.h>
+
+using std::vector;
+
+namespace boolean
+{
+
+// A hasher for the hash() hooks on cube and cover. Cubes that differ only by
+// trailing tautology words compare equal, so those words are skipped to keep
+// the hash consistent with operator==.
+struct hasher
+{
+	hasher();
+	hasher(uint64_t seed);
+	~hasher();
+
+	uint64_t state;
+
+	void put(uint64_t value);
+	void put(const vector<unsigned int> *values);
+	void put(const unsigned int *values, int n);
+	void put(const vector<cube> *cubes);
+
+	uint64_t get() const;
+};
+
+uint64_t hash(const cube &c);
+
+}
@@ -0,0 +1,175 @@
+/*
+ * multiplier.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/multiplier.h>
+#include <boolean/parallel.h>
+
+#include <algorithm>
+
+namespace boolean
+{
+
+// A 3:2 or 2:2 counter on bits [first, first+count) of column
+struct counter
+{
+	counter(int column, int first, int count)
+	{
+		this->column = column;
+		this->first = first;
+		this->count = count;
+	}
+	~counter() {}
+
+	int column;
+	int first;
+	int count;
+
+	cover sum;
+	cover carry;
+};
+
+// The Dadda heights 2, 3, 4, 6, 9, 13... are each floor(3/2) of the last.
+// Returns the largest one below height.
+static int dadda_target(int height)
+{
+	int d = 2;
+	while (d*3/2 < height)
+		d = d*3/2;
+	return d;
+}
+
+// Pick the counters for one stage of the reduction.
+static vector<counter> plan(const vector<vector<cover> > &columns, int style)
+{
+	vector<counter> result;
+	if (style == DADDA_TREE) {
+		int max_height = 0;
+		for (int k = 0; k < (int)columns.size(); k++)
+			max_height = std::max(max_height, (int)columns[k].size());
+		int d = dadda_target(max_height);
+
+		int carries = 0;
+		for (int k = 0; k < (int)columns.size(); k++) {
+			int h = (int)columns[k].size() + carries;
+			int first = 0;
+			carries = 0;
+			while (h > d and first+2 <= (int)columns[k].size()) {
+				if (h == d+1 or first+3 > (int)columns[k].size()) {
+					result.push_back(counter(k, first, 2));
+					first += 2;
+					h -= 1;
+				} else {
+					result.push_back(counter(k, first, 3));
+					first += 3;
+					h -= 2;
+				}
+				carries++;
+			}
+		}
+	} else {
+		for (int k = 0; k < (int)columns.size(); k++) {
+			int h = (int)columns[k].size();
+			int first = 0;
+			for (; h - first >= 3; first += 3)
+				result.push_back(counter(k, first, 3));
+			if (h - first == 2)
+				result.push_back(counter(k, first, 2));
+		}
+	}
+	return result;
+}
+
+bitset carry_save(vector<vector<cover> > columns, int style, int adder, bool minimize, int threads)
+{
+	int width = (int)columns.size();
+
+	// Null bits don't contribute anything to the sum
+	for (int k = 0; k < width; k++)
+		for (int i = (int)columns[k].size()-1; i >= 0; i--)
+			if (columns[k][i].is_null())
+				columns[k].erase(columns[k].begin() + i);
+
+	if (style == SHIFT_ADD) {
+		bitset result;
+		result.bits.resize(width, cover(0));
+		for (int k = 0; k < width; k++) {
+			for (int i = 0; i < (int)columns[k].size(); i++) {
+				bitset row;
+				row.bits.resize(width, cover(0));
+				row.bits[k] = columns[k][i];
+				result = add(result, row, cover(0), adder, threads);
+				result.bits.pop_back();
+			}
+		}
+		return result;
+	}
+
+	while (true) {
+		int max_height = 0;
+		for (int k = 0; k < width; k++)
+			max_height = std::max(max_height, (int)columns[k].size());
+		if (max_height <= 2)
+			break;
+
+		vector<counter> counters = plan(columns, style);
+		parallel_for(0, (int)counters.size(), threads, [&](int i) {
+			counter &c = counters[i];
+			const vector<cover> &in = columns[c.column];
+			if (c.count == 3) {
+				c.sum = full_sum(in[c.first], in[c.first+1], in[c.first+2]);
+				c.carry = full_carry(in[c.first], in[c.first+1], in[c.first+2]);
+			} else {
+				c.sum = in[c.first] ^ in[c.first+1];
+				c.carry = in[c.first] & in[c.first+1];
+			}
+			if (minimize) {
+				c.sum.espresso();
+				c.carry.espresso();
+			}
+		});
+
+		// Each column keeps the sums of its own counters, then the bits that
+		// weren't counted, then the carries from the column below.
+		vector<vector<cover> > next(width);
+		vector<int> used(width, 0);
+		for (int i = 0; i < (int)counters.size(); i++) {
+			counter &c = counters[i];
+			next[c.column].push_back(c.sum);
+			used[c.column] = c.first + c.count;
+		}
+		for (int k = 0; k < width; k++)
+			next[k].insert(next[k].end(), columns[k].begin() + used[k], columns[k].end());
+		for (int i = 0; i < (int)counters.size(); i++) {
+			counter &c = counters[i];
+			if (c.column+1 < width)
+				next[c.column+1].push_back(c.carry);
+		}
+
+		for (int k = 0; k < width; k++)
+			for (int i = (int)next[k].size()-1; i >= 0; i--)
+				if (next[k][i].is_null())
+					next[k].erase(next[k].begin() + i);
+
+		columns.swap(next);
+	}
+
+	bitset row0, row1;
+	row0.bits.resize(width, cover(0));
+	row1.bits.resize(width, cover(0));
+	for (int k = 0; k < width; k++) {
+		if (columns[k].size() > 0)
+			row0.bits[k] = columns[k][0];
+		if (columns[k].size() > 1)
+			row1.bits[k] = columns[k][1];
+	}
+
+	bitset result = add(row0, row1, cover(0), adder, threads);
+	result.bits.pop_back();
+	return result;
+}
+
+}
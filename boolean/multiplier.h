@@ -0,0 +1,36 @@
+/*
+ * multiplier.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/adder.h>
+
+namespace boolean
+{
+
+// The structure used to sum the partial products of a symbolic multiply.
+enum multiplier_style
+{
+	// Add each shifted partial product to the running sum in turn.
+	SHIFT_ADD = 0,
+	// Carry-save reduction, applying as many 3:2 and 2:2 counters as
+	// possible at every stage.
+	WALLACE_TREE = 1,
+	// Carry-save reduction, applying only as many counters as needed to
+	// bring each column down to the next height in 2, 3, 4, 6, 9, 13...
+	DADDA_TREE = 2
+};
+
+// Reduce columns of partial product bits, columns[i] holding the bits of
+// weight 2^i, with a carry-save tree followed by a single adder of the given
+// style. The result has one bit per column, carries out of the last column
+// are dropped. When minimize is set, the outputs of every counter are run
+// through espresso. The counters within a stage are independent and are
+// built on up to threads threads.
+bitset carry_save(vector<vector<cover> > columns, int style = WALLACE_TREE, int adder = RIPPLE_CARRY, bool minimize = false, int threads = 1);
+
+}
@@ -0,0 +1,78 @@
+/*
+ * parallel.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/task.h>
+#include <boolean/trace.h>
+
+#include <future>
+#include <vector>
+
+namespace boolean
+{
+
+// Run both tasks, handing the left one off to another thread if we are
+// allowed more than one. Each task is told how many threads it may use.
+template <typename L, typename R>
+void fork_join(int threads, L left, R right)
+{
+	if (threads > 1) {
+		boolean::task *current = current_task();
+		bool nested = in_traced_call();
+		std::future<void> job = std::async(std::launch::async, [current, nested, &left](int t) {
+			task_scope scope(current);
+			trace_scope traced(nested);
+			left(t);
+		}, threads/2);
+		right(threads - threads/2);
+		job.get();
+	} else {
+		left(1);
+		right(1);
+	}
+}
+
+// Call f(i) for every i in [begin, end). The range is split into contiguous
+// chunks, one per thread.
+template <typename F>
+void parallel_for(int begin, int end, int threads, F f)
+{
+	int n = end - begin;
+	if (threads > n)
+		threads = n;
+
+	if (threads <= 1) {
+		for (int i = begin; i < end; i++)
+			f(i);
+		return;
+	}
+
+	boolean::task *current = current_task();
+	bool nested = in_traced_call();
+	std::vector<std::future<void> > jobs;
+	jobs.reserve(threads-1);
+	for (int t = 1; t < threads; t++) {
+		int lo = begin + (int)((long)n*t/threads);
+		int hi = begin + (int)((long)n*(t+1)/threads);
+		jobs.push_back(std::async(std::launch::async, [lo, hi, current, nested, &f]() {
+			task_scope scope(current);
+			trace_scope traced(nested);
+			for (int i = lo; i < hi; i++)
+				f(i);
+		}));
+	}
+
+	int hi = begin + n/threads;
+	for (int i = begin; i < hi; i++)
+		f(i);
+
+	for (int t = 0; t < (int)jobs.size(); t++)
+		jobs[t].get();
+}
+
+}
@@ -0,0 +1,361 @@
+/*
+ * pla.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/pla.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boolean
+{
+
+pla::pla()
+{
+	inputs = 0;
+	outputs = 0;
+	// the default type in Berkeley PLA files
+	type = PLA_F | PLA_D;
+}
+
+pla::~pla()
+{
+}
+
+static bool is_space(char c)
+{
+	return c == ' ' or c == '\t' or c == '\r' or c == '|';
+}
+
+// Reads the whitespace separated names up to the end of the line.
+static const char *names(const char *i, const char *end, vector<string> *result)
+{
+	result->clear();
+	while (i < end and *i != '\n') {
+		while (i < end and is_space(*i))
+			i++;
+		const char *start = i;
+		while (i < end and *i != '\n' and !is_space(*i))
+			i++;
+		if (i > start)
+			result->push_back(string(start, i));
+	}
+	return i;
+}
+
+static const char *number(const char *i, const char *end, int *result)
+{
+	while (i < end and is_space(*i))
+		i++;
+	*result = 0;
+	const char *start = i;
+	while (i < end and *i >= '0' and *i <= '9')
+		*result = *result*10 + (*i++ - '0');
+	return i > start ? i : NULL;
+}
+
+bool parse_pla(const char *data, size_t length, pla *result)
+{
+	const char *i = data, *end = data + length;
+	*result = pla();
+	result->outputs = -1;
+	result->inputs = -1;
+
+	int words = 0;
+	int expected = 0;
+	cube term;
+	while (i < end) {
+		while (i < end and (is_space(*i) or *i == '\n'))
+			i++;
+		if (i >= end)
+			break;
+
+		if (*i == '#') {
+			while (i < end and *i != '\n')
+				i++;
+			continue;
+		}
+
+		if (*i == '.') {
+			const char *start = ++i;
+			while (i < end and !is_space(*i) and *i != '\n')
+				i++;
+			string directive(start, i);
+
+			if (directive == "i") {
+				if ((i = number(i, end, &result->inputs)) == NULL)
+					return false;
+			} else if (directive == "o") {
+				if ((i = number(i, end, &result->outputs)) == NULL)
+					return false;
+			} else if (directive == "p") {
+				if ((i = number(i, end, &expected)) == NULL)
+					return false;
+			} else if (directive == "ilb") {
+				i = names(i, end, &result->input_names);
+			} else if (directive == "ob") {
+				i = names(i, end, &result->output_names);
+			} else if (directive == "type") {
+				vector<string> type;
+				i = names(i, end, &type);
+				if (type.size() != 1)
+					return false;
+				result->type = 0;
+				for (int j = 0; j < (int)type[0].size(); j++) {
+					if (type[0][j] == 'f')
+						result->type |= PLA_F;
+					else if (type[0][j] == 'd')
+						result->type |= PLA_D;
+					else if (type[0][j] == 'r')
+						result->type |= PLA_R;
+					else
+						return false;
+				}
+			} else if (directive == "e" or directive == "end") {
+				break;
+			}
+
+			// anything else on the line is ignored
+			while (i < end and *i != '\n')
+				i++;
+			continue;
+		}
+
+		if (result->inputs < 0)
+			return false;
+		if (result->outputs < 0)
+			result->outputs = 1;
+
+		if (words == 0) {
+			words = (result->inputs+15)/16;
+			term.values.resize(words);
+			result->on.bits.resize(result->outputs);
+			if (result->type & PLA_D)
+				result->dc.bits.resize(result->outputs);
+			if (result->type & PLA_R)
+				result->off.bits.resize(result->outputs);
+			if (expected > 0 and result->outputs == 1)
+				result->on.bits[0].reserve(expected);
+		}
+
+		// the input plane goes straight into the cube words
+		for (int w = 0; w < words; w++)
+			term.values[w] = 0xFFFFFFFF;
+		for (int uid = 0; uid < result->inputs; uid++) {
+			while (i < end and is_space(*i))
+				i++;
+			if (i >= end)
+				return false;
+
+			unsigned int shift = 2*(uid%16);
+			switch (*i++) {
+			case '0': term.values[uid/16] &= ~(2u << shift); break;
+			case '1': term.values[uid/16] &= ~(1u << shift); break;
+			case '-': case '~': case 'x': case 'X': case '2': break;
+			default: return false;
+			}
+		}
+
+		for (int j = 0; j < result->outputs; j++) {
+			while (i < end and is_space(*i))
+				i++;
+			if (i >= end)
+				return false;
+
+			char c = *i++;
+			if (c == '1' or c == '4') {
+				if (result->type & PLA_F)
+					result->on.bits[j].cubes.push_back(term);
+			} else if (c == '0') {
+				if (result->type & PLA_R)
+					result->off.bits[j].cubes.push_back(term);
+			} else if (c == '-' or c == '2') {
+				if (result->type & PLA_D)
+					result->dc.bits[j].cubes.push_back(term);
+			} else if (c != '~' and c != '3') {
+				return false;
+			}
+		}
+
+		while (i < end and is_space(*i))
+			i++;
+		if (i < end and *i != '\n')
+			return false;
+	}
+
+	if (result->inputs < 0)
+		return false;
+	if (result->outputs < 0)
+		result->outputs = 1;
+	if (words == 0) {
+		result->on.bits.resize(result->outputs);
+		if (result->type & PLA_D)
+			result->dc.bits.resize(result->outputs);
+		if (result->type & PLA_R)
+			result->off.bits.resize(result->outputs);
+	}
+	return true;
+}
+
+bool read_pla(const char *path, pla *result)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return false;
+	}
+
+	if (st.st_size == 0) {
+		close(fd);
+		return parse_pla("", 0, result);
+	}
+
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+	bool ok = parse_pla((const char*)data, st.st_size, result);
+	munmap(data, st.st_size);
+	return ok;
+}
+
+// Flush the buffer to the file once it gets big. Without a file everything
+// stays in the buffer.
+static bool flush(string &buffer, FILE *fptr, size_t limit)
+{
+	if (fptr == NULL or buffer.size() < limit)
+		return true;
+
+	bool ok = fwrite(buffer.data(), 1, buffer.size(), fptr) == buffer.size();
+	buffer.clear();
+	return ok;
+}
+
+// Appends one line per cube of each output, marking that output with val and
+// leaving the rest as ~.
+static bool format_plane(string &buffer, FILE *fptr, const bitset &set, int inputs, int outputs, char val)
+{
+	string line(inputs + 1 + outputs + 1, '-');
+	line[inputs] = ' ';
+	line[inputs + 1 + outputs] = '\n';
+	for (int j = 0; j < (int)set.bits.size() and j < outputs; j++) {
+		for (int k = 0; k < outputs; k++)
+			line[inputs + 1 + k] = (k == j ? val : '~');
+
+		const cover &c = set.bits[j];
+		for (int l = 0; l < c.size(); l++) {
+			if (c[l].is_null())
+				continue;
+
+			for (int uid = 0; uid < inputs; uid++) {
+				unsigned int w = uid/16 < c[l].size() ? c[l].values[uid/16] : 0xFFFFFFFF;
+				unsigned int v = (w >> (2*(uid%16))) & 3;
+				line[uid] = (v == 2 ? '1' : (v == 1 ? '0' : '-'));
+			}
+			buffer += line;
+			if (!flush(buffer, fptr, 1 << 20))
+				return false;
+		}
+	}
+	return true;
+}
+
+// The number of lines format_plane() writes for set.
+static int plane_lines(const bitset &set, int outputs)
+{
+	int count = 0;
+	for (int j = 0; j < (int)set.bits.size() and j < outputs; j++)
+		for (int l = 0; l < set.bits[j].size(); l++)
+			count += not set.bits[j][l].is_null();
+	return count;
+}
+
+static bool format_pla(const pla &p, string &buffer, FILE *fptr)
+{
+	buffer += ".i " + std::to_string(p.inputs) + "\n";
+	buffer += ".o " + std::to_string(p.outputs) + "\n";
+	if (!p.input_names.empty()) {
+		buffer += ".ilb";
+		for (int i = 0; i < (int)p.input_names.size(); i++)
+			buffer += " " + p.input_names[i];
+		buffer += "\n";
+	}
+	if (!p.output_names.empty()) {
+		buffer += ".ob";
+		for (int i = 0; i < (int)p.output_names.size(); i++)
+			buffer += " " + p.output_names[i];
+		buffer += "\n";
+	}
+
+	int type = p.type;
+	if (!p.dc.bits.empty())
+		type |= PLA_D;
+	if (!p.off.bits.empty())
+		type |= PLA_R;
+	buffer += ".type ";
+	if (type & PLA_F)
+		buffer += "f";
+	if (type & PLA_D)
+		buffer += "d";
+	if (type & PLA_R)
+		buffer += "r";
+	buffer += "\n";
+
+	// only the lines that are actually written
+	int count = 0;
+	if (type & PLA_F)
+		count += plane_lines(p.on, p.outputs);
+	if (type & PLA_D)
+		count += plane_lines(p.dc, p.outputs);
+	if (type & PLA_R)
+		count += plane_lines(p.off, p.outputs);
+	buffer += ".p " + std::to_string(count) + "\n";
+
+	if (fptr == NULL)
+		buffer.reserve(buffer.size() + (size_t)count*(p.inputs + p.outputs + 2) + 4);
+	if ((type & PLA_F) and !format_plane(buffer, fptr, p.on, p.inputs, p.outputs, '1'))
+		return false;
+	if ((type & PLA_D) and !format_plane(buffer, fptr, p.dc, p.inputs, p.outputs, '-'))
+		return false;
+	if ((type & PLA_R) and !format_plane(buffer, fptr, p.off, p.inputs, p.outputs, '0'))
+		return false;
+	buffer += ".e\n";
+	return flush(buffer, fptr, 0);
+}
+
+string format_pla(const pla &p)
+{
+	string result;
+	format_pla(p, result, NULL);
+	return result;
+}
+
+bool write_pla(const char *path, const pla &p)
+{
+	FILE *fptr = fopen(path, "w");
+	if (fptr == NULL)
+		return false;
+
+	string buffer;
+	buffer.reserve((1 << 20) + 4096);
+	bool ok = format_pla(p, buffer, fptr);
+	ok = (fclose(fptr) == 0) and ok;
+	return ok;
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * pla.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/bitset.h>
+
+#include <string>
+#include <cstddef>
+
+using std::string;
+
+namespace boolean
+{
+
+// Which sets the output plane of a PLA describes, combined as in the .type
+// directive: f, fd, fr or fdr.
+enum pla_type
+{
+	PLA_F = 1,
+	PLA_D = 2,
+	PLA_R = 4
+};
+
+// A multiple output function in Berkeley PLA form. Input i is variable i
+// and each output is one cover in on, dc and off, which are only filled in
+// when the type says the file describes them.
+struct pla
+{
+	pla();
+	~pla();
+
+	int inputs;
+	int outputs;
+	int type;
+
+	vector<string> input_names;
+	vector<string> output_names;
+
+	bitset on;
+	bitset dc;
+	bitset off;
+};
+
+// Parse a PLA straight into cube words. Returns false if the text is not
+// a well formed PLA.
+bool parse_pla(const char *data, size_t length, pla *result);
+
+// Map the file and parse it, false if it can't be read or parsed.
+bool read_pla(const char *path, pla *result);
+
+// Format a PLA with one line per output of each cube. write_pla() streams
+// through a buffer that is flushed every megabyte, so the file sees a few
+// large writes and the text is never held in memory all at once.
+string format_pla(const pla &p);
+bool write_pla(const char *path, const pla &p);
+
+}
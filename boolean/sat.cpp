@@ -0,0 +1,424 @@
+/*
+ * sat.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/sat.h>
+#include <boolean/task.h>
+
+#include <algorithm>
+
+namespace boolean
+{
+
+sat::sat()
+{
+	increment = 1.0;
+	head = 0;
+	ok = true;
+}
+
+sat::~sat()
+{
+}
+
+int sat::variables() const
+{
+	return (int)assigns.size();
+}
+
+int sat::new_variable()
+{
+	int var = (int)assigns.size();
+	assigns.push_back(-1);
+	level.push_back(0);
+	reason.push_back(-1);
+	phase.push_back(0);
+	activity.push_back(0.0);
+	watches.resize(2*assigns.size());
+	return var;
+}
+
+// Returns 1 if lit is true, 0 if it is false and -1 if it is unassigned.
+int sat::value(int lit) const
+{
+	int val = assigns[lit>>1];
+	return val < 0 ? -1 : val ^ (lit&1);
+}
+
+void sat::assign(int lit, int from)
+{
+	assigns[lit>>1] = 1 ^ (lit&1);
+	level[lit>>1] = (int)trail_lim.size();
+	reason[lit>>1] = from;
+	trail.push_back(lit);
+}
+
+// Clauses may only be added at the root. Returns false if the clauses are
+// now known to be unsatisfiable.
+bool sat::add_clause(vector<int> lits)
+{
+	if (!ok)
+		return false;
+
+	sort(lits.begin(), lits.end());
+	int j = 0;
+	for (int i = 0; i < (int)lits.size(); i++) {
+		// x | ~x is always satisfied
+		if (j > 0 and lits[i] == (lits[j-1]^1))
+			return true;
+
+		int val = value(lits[i]);
+		if (val == 1)
+			return true;
+		else if (val < 0 and (j == 0 or lits[i] != lits[j-1]))
+			lits[j++] = lits[i];
+	}
+	lits.resize(j);
+
+	if (lits.empty()) {
+		ok = false;
+	} else if (lits.size() == 1) {
+		assign(lits[0], -1);
+		ok = (propagate() < 0);
+	} else {
+		int index = (int)clauses.size();
+		watches[lits[0]].push_back(index);
+		watches[lits[1]].push_back(index);
+		clauses.push_back(lits);
+	}
+	return ok;
+}
+
+// Returns the index of a conflicting clause or -1 if there is none.
+int sat::propagate()
+{
+	while (head < (int)trail.size()) {
+		int falsified = trail[head++]^1;
+		vector<int> &ws = watches[falsified];
+
+		int i = 0, j = 0;
+		while (i < (int)ws.size()) {
+			int index = ws[i++];
+			vector<int> &c = clauses[index];
+			if (c[0] == falsified)
+				std::swap(c[0], c[1]);
+
+			if (value(c[0]) == 1) {
+				ws[j++] = index;
+				continue;
+			}
+
+			// look for a new literal to watch
+			bool moved = false;
+			for (int k = 2; k < (int)c.size() and !moved; k++) {
+				if (value(c[k]) != 0) {
+					std::swap(c[1], c[k]);
+					watches[c[1]].push_back(index);
+					moved = true;
+				}
+			}
+			if (moved)
+				continue;
+
+			ws[j++] = index;
+			if (value(c[0]) == 0) {
+				while (i < (int)ws.size())
+					ws[j++] = ws[i++];
+				ws.resize(j);
+				return index;
+			}
+			assign(c[0], index);
+		}
+		ws.resize(j);
+	}
+	return -1;
+}
+
+void sat::bump(int var)
+{
+	activity[var] += increment;
+	if (activity[var] > 1e100) {
+		for (int i = 0; i < (int)activity.size(); i++)
+			activity[i] *= 1e-100;
+		increment *= 1e-100;
+	}
+}
+
+// Learn the first unique implication point clause. The asserting literal is
+// placed first and a literal from the backtrack level second.
+void sat::analyze(int conflict, vector<int> *learnt, int *backtrack)
+{
+	vector<bool> seen(assigns.size(), false);
+	learnt->assign(1, 0);
+
+	int current = (int)trail_lim.size();
+	int count = 0;
+	int lit = -1;
+	int index = (int)trail.size()-1;
+	do {
+		const vector<int> &c = clauses[conflict];
+		// the implied literal of a reason clause is always first
+		for (int i = (lit < 0 ? 0 : 1); i < (int)c.size(); i++) {
+			int var = c[i]>>1;
+			if (!seen[var] and level[var] > 0) {
+				seen[var] = true;
+				bump(var);
+				if (level[var] == current)
+					count++;
+				else
+					learnt->push_back(c[i]);
+			}
+		}
+
+		while (!seen[trail[index]>>1])
+			index--;
+		lit = trail[index--];
+		conflict = reason[lit>>1];
+		seen[lit>>1] = false;
+		count--;
+	} while (count > 0);
+	(*learnt)[0] = lit^1;
+
+	*backtrack = 0;
+	for (int i = 2; i < (int)learnt->size(); i++)
+		if (level[(*learnt)[i]>>1] > level[(*learnt)[1]>>1])
+			std::swap((*learnt)[1], (*learnt)[i]);
+	if (learnt->size() > 1)
+		*backtrack = level[(*learnt)[1]>>1];
+
+	increment /= 0.95;
+}
+
+void sat::cancel(int lvl)
+{
+	if ((int)trail_lim.size() <= lvl)
+		return;
+
+	for (int i = (int)trail.size()-1; i >= trail_lim[lvl]; i--) {
+		int var = trail[i]>>1;
+		phase[var] = assigns[var];
+		assigns[var] = -1;
+		reason[var] = -1;
+	}
+	trail.resize(trail_lim[lvl]);
+	trail_lim.resize(lvl);
+	head = (int)trail.size();
+}
+
+// The unassigned variable with the highest activity, or -1 if every
+// variable is assigned.
+int sat::pick() const
+{
+	int result = -1;
+	for (int i = 0; i < (int)assigns.size(); i++)
+		if (assigns[i] < 0 and (result < 0 or activity[i] > activity[result]))
+			result = i;
+	return result;
+}
+
+// The i-th element of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+static long luby(long i)
+{
+	long size = 1, seq = 0;
+	while (size < i+1) {
+		seq++;
+		size = 2*size+1;
+	}
+
+	long result = 1;
+	while (size-1 != i) {
+		size = (size-1)>>1;
+		seq--;
+		i = i % size;
+	}
+	while (seq-- > 0)
+		result *= 2;
+	return result;
+}
+
+bool sat::solve()
+{
+	model.clear();
+	if (!ok)
+		return false;
+
+	long restarts = 0;
+	long conflicts = 0;
+	long limit = 100*luby(restarts);
+	vector<int> learnt;
+	while (true) {
+		int conflict = propagate();
+		if (conflict >= 0) {
+			if (trail_lim.empty()) {
+				ok = false;
+				return false;
+			}
+
+			int backtrack = 0;
+			analyze(conflict, &learnt, &backtrack);
+			cancel(backtrack);
+			if (learnt.size() == 1) {
+				assign(learnt[0], -1);
+			} else {
+				int index = (int)clauses.size();
+				watches[learnt[0]].push_back(index);
+				watches[learnt[1]].push_back(index);
+				clauses.push_back(learnt);
+				assign(learnt[0], index);
+			}
+			conflicts++;
+		} else if (conflicts >= limit) {
+			// A cancelled search gives up without an answer. It reports
+			// unsatisfiable, so callers have to check is_cancelled() before
+			// trusting that.
+			if (is_cancelled()) {
+				cancel(0);
+				return false;
+			}
+
+			cancel(0);
+			conflicts = 0;
+			limit = 100*luby(++restarts);
+		} else {
+			int var = pick();
+			if (var < 0) {
+				model = assigns;
+				cancel(0);
+				return true;
+			}
+
+			trail_lim.push_back((int)trail.size());
+			assign(2*var + (phase[var] == 1 ? 0 : 1), -1);
+		}
+	}
+}
+
+// Maps the variables of a cover onto solver variables as they are found.
+static int literal(sat &solver, vector<int> &vars, int uid, int val)
+{
+	if (uid >= (int)vars.size())
+		vars.resize(uid+1, -1);
+	if (vars[uid] < 0)
+		vars[uid] = solver.new_variable();
+	return 2*vars[uid] + (val == 1 ? 0 : 1);
+}
+
+// The complement of a cover is already in conjunctive normal form, one
+// clause per cube.
+static void add_complement(sat &solver, vector<int> &vars, const cover &s)
+{
+	vector<int> clause;
+	for (int i = 0; i < s.size(); i++) {
+		if (s[i].is_null())
+			continue;
+
+		clause.clear();
+		for (int uid = 0; uid < s[i].size()*16; uid++) {
+			int val = s[i].get(uid);
+			if (val == 0 or val == 1)
+				clause.push_back(literal(solver, vars, uid, 1-val));
+		}
+		solver.add_clause(clause);
+	}
+}
+
+// The cover itself needs a selector variable per cube that implies each of
+// its literals, and a clause requiring at least one selector.
+static void add_cover(sat &solver, vector<int> &vars, const cover &s)
+{
+	vector<int> any;
+	for (int i = 0; i < s.size(); i++) {
+		if (s[i].is_null())
+			continue;
+
+		int select = solver.new_variable();
+		any.push_back(2*select);
+		for (int uid = 0; uid < s[i].size()*16; uid++) {
+			int val = s[i].get(uid);
+			if (val == 0 or val == 1)
+				solver.add_clause({2*select+1, literal(solver, vars, uid, val)});
+		}
+	}
+	solver.add_clause(any);
+}
+
+bool sat_is_tautology(const cover &s)
+{
+	sat solver;
+	vector<int> vars;
+	add_complement(solver, vars, s);
+	return !solver.solve() and !is_cancelled();
+}
+
+bool sat_is_subset(const cover &s1, const cover &s2)
+{
+	sat solver;
+	vector<int> vars;
+	add_complement(solver, vars, s2);
+	add_cover(solver, vars, s1);
+	return !solver.solve() and !is_cancelled();
+}
+
+bool sat_are_mutex(const cover &s1, const cover &s2)
+{
+	sat solver;
+	vector<int> vars;
+	add_cover(solver, vars, s1);
+	add_cover(solver, vars, s2);
+	return !solver.solve() and !is_cancelled();
+}
+
+bool sat_are_equal(const cover &s1, const cover &s2)
+{
+	return sat_is_subset(s1, s2) and sat_is_subset(s2, s1);
+}
+
+// Each cube gets a selector equal to it, and a chain of variables carries
+// the parity of the selectors so far. The xor is constant val exactly when
+// the last of them can't be the other value.
+bool sat_xor_is_constant(const vector<cube> &cubes, int val)
+{
+	sat solver;
+	vector<int> vars;
+	int parity = -1;
+	vector<int> clause;
+	for (int i = 0; i < (int)cubes.size(); i++) {
+		if (cubes[i].is_null())
+			continue;
+
+		int select = solver.new_variable();
+		clause.assign(1, 2*select);
+		for (int uid = 0; uid < cubes[i].size()*16; uid++) {
+			int v = cubes[i].get(uid);
+			if (v == 0 or v == 1) {
+				int lit = literal(solver, vars, uid, v);
+				solver.add_clause({2*select+1, lit});
+				clause.push_back(lit^1);
+			}
+		}
+		solver.add_clause(clause);
+
+		if (parity < 0) {
+			parity = select;
+		} else {
+			int next = solver.new_variable();
+			solver.add_clause({2*next+1, 2*parity, 2*select});
+			solver.add_clause({2*next+1, 2*parity+1, 2*select+1});
+			solver.add_clause({2*next, 2*parity+1, 2*select});
+			solver.add_clause({2*next, 2*parity, 2*select+1});
+			parity = next;
+		}
+	}
+
+	// with no cubes the xor is zero
+	if (parity < 0)
+		return val == 0;
+
+	solver.add_clause({2*parity + (val == 1 ? 1 : 0)});
+	return !solver.solve() and !is_cancelled();
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+ * sat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+namespace boolean
+{
+
+// A small conflict driven clause learning SAT solver. Literals are encoded
+// as 2*var for the positive literal and 2*var+1 for the negative one.
+// Conflicts are analyzed to the first unique implication point, decisions
+// follow variable activity with saved phases, and the search restarts on
+// the Luby sequence. Learned clauses are never deleted since the problems
+// built from covers are short lived.
+struct sat
+{
+	sat();
+	~sat();
+
+	// Cover queries switch from shannon expansion to the solver once the
+	// support is wider than this.
+	static const int min_support = 32;
+
+	vector<vector<int> > clauses;
+
+	// The clauses watching each literal, the watched literals of a clause
+	// are always its first two.
+	vector<vector<int> > watches;
+
+	// Per variable: the assigned value or -1, the decision level it was
+	// assigned at, the clause that implied it or -1 for decisions.
+	vector<int> assigns;
+	vector<int> level;
+	vector<int> reason;
+	vector<int> phase;
+	vector<double> activity;
+	double increment;
+
+	vector<int> trail;
+	vector<int> trail_lim;
+	int head;
+
+	// False once the clauses are known to be unsatisfiable.
+	bool ok;
+
+	// The satisfying assignment found by the last call to solve().
+	vector<int> model;
+
+	int variables() const;
+	int new_variable();
+	bool add_clause(vector<int> lits);
+	bool solve();
+
+private:
+	int value(int lit) const;
+	void assign(int lit, int from);
+	int propagate();
+	void analyze(int conflict, vector<int> *learnt, int *backtrack);
+	void cancel(int lvl);
+	void bump(int var);
+	int pick() const;
+};
+
+// Queries on covers through a CNF encoding. Each returns the exact answer,
+// except that a query the current task cancels returns false rather than an
+// answer it didn't finish, like the shannon expansions do.
+bool sat_is_tautology(const cover &s);
+bool sat_is_subset(const cover &s1, const cover &s2);
+bool sat_are_mutex(const cover &s1, const cover &s2);
+bool sat_are_equal(const cover &s1, const cover &s2);
+
+// Whether the xor of the cubes is the constant val, for esops too wide to
+// convert to a cover.
+bool sat_xor_is_constant(const vector<cube> &cubes, int val);
+
+}
@@ -10,11 +10,12 @@
 namespace boolean
 {
 
-signed_int::signed_int() { }
-signed_int::signed_int(int width, int offset) : bitset(width, offset) { }
+signed_int::signed_int() { fixed = 0; }
+signed_int::signed_int(int width, int offset) : bitset(width, offset) { fixed = 0; }
 
 signed_int::signed_int(long value)
 {
+	fixed = 0;
 	while (value != 0 and value != -1) {
 		bits.push_back(cover(value & 1));
 		value >>= 1;
@@ -22,10 +23,24 @@ signed_int::signed_int(long value)
 	bits.push_back(cover(value & 1));
 }
 
-signed_int::signed_int(const bitset &n) : bitset(n) { }
-signed_int::signed_int(const signed_int &n) : bitset(n) { }
+signed_int::signed_int(const bitset &n) : bitset(n) { fixed = 0; }
+signed_int::signed_int(const signed_int &n) : bitset(n) { fixed = n.fixed; }
 signed_int::~signed_int() { }
 
+// Truncate or sign extend this value to width bits and keep all further
+// arithmetic on it at that width.
+signed_int &signed_int::fix(int width)
+{
+	fixed = width;
+	resize(width);
+	return *this;
+}
+
+static int fixed_width(const signed_int &n0, const signed_int &n1)
+{
+	return std::max(n0.fixed, n1.fixed);
+}
+
 cover signed_int::extend() const
 {
 	if (bits.empty()) {
@@ -64,96 +79,182 @@ signed_int &signed_int::operator/=(const signed_int &n)
 	return *this;
 }*/
 
+signed_int &signed_int::operator&=(const signed_int &n)
+{
+	*this = *this & n;
+	return *this;
+}
+
+signed_int &signed_int::operator|=(const signed_int &n)
+{
+	*this = *this | n;
+	return *this;
+}
+
+signed_int &signed_int::operator^=(const signed_int &n)
+{
+	*this = *this ^ n;
+	return *this;
+}
+
+signed_int &signed_int::operator<<=(int s)
+{
+	*this = *this << s;
+	return *this;
+}
+
+signed_int &signed_int::operator>>=(int s)
+{
+	*this = *this >> s;
+	return *this;
+}
+
+// -n only needs one more bit than n, to hold the negation of the most
+// negative value, so the sign extension is never iterated.
 signed_int operator-(const signed_int &n)
 {
+	signed_int a = n;
+	a.resize(n.fixed > 0 ? n.fixed : n.bits.size()+1);
+
 	signed_int result;
+	result.bits.reserve(a.bits.size());
 	cover carry = 1;
-	for (int i = 0; i < (int)n.bits.size(); i++)
-	{
-		result.bits.push_back((~n.bits[i]&~carry) | (n.bits[i]&carry));
-		carry = ~n.bits[i]&carry;
-	}
-
-	cover inf = ~n.extend()&carry;
-	while (inf != carry)
+	for (int i = 0; i < (int)a.bits.size(); i++)
 	{
-		result.bits.push_back((~n.extend()&~carry) | (n.extend()&carry));
-		carry = inf;
-		inf = ~n.extend()&carry;
+		result.bits.push_back(xnor(a.bits[i], carry));
+		carry = ~a.bits[i]&carry;
 	}
 
+	result.fixed = n.fixed;
 	return result;
 }
 
 signed_int operator+(const signed_int &n0, const signed_int &n1)
 {
-	signed_int result;
-	cover carry = 0, inf;
-	int m = (int)std::min(n0.bits.size(), n1.bits.size());
-	for (int i = 0; i < m; i++)
-	{
-		result.bits.push_back((n0.bits[i]&~n1.bits[i]&~carry) | (~n0.bits[i]&n1.bits[i]&~carry) | (~n0.bits[i]&~n1.bits[i]&carry));
-		carry = (n0.bits[i]&n1.bits[i]) | (n0.bits[i]&carry) | (n1.bits[i]&carry);
-	}
-	for (int i = m; i < (int)n0.bits.size(); i++)
-	{
-		result.bits.push_back((n0.bits[i]&~n1.extend()&~carry) | (~n0.bits[i]&n1.extend()&~carry) | (~n0.bits[i]&~n1.extend()&carry));
-		carry = (n0.bits[i]&n1.extend()) | (n0.bits[i]&carry) | (n1.extend()&carry);
-	}
-	for (int i = m; i < (int)n1.bits.size(); i++)
-	{
-		result.bits.push_back((n0.extend()&~n1.bits[i]&~carry) | (~n0.extend()&n1.bits[i]&~carry) | (~n0.extend()&~n1.bits[i]&carry));
-		carry = (n0.extend()&n1.bits[i]) | (n0.extend()&carry) | (n1.bits[i]&carry);
-	}
+	return add(n0, n1, RIPPLE_CARRY);
+}
 
-	inf = (n0.extend()&n1.extend()) | (n0.extend()&carry) | (n1.extend()&carry);
-	while (inf != carry)
-	{
-		result.bits.push_back((n0.extend()&~n1.extend()&~carry) | (~n0.extend()&n1.extend()&~carry) | (~n0.extend()&~n1.extend()&carry));
-		carry = inf;
-		inf = (n0.extend()&n1.extend()) | (n0.extend()&carry) | (n1.extend()&carry);
-	}
+signed_int operator-(const signed_int &n0, const signed_int &n1)
+{
+	return subtract(n0, n1, RIPPLE_CARRY);
+}
 
+// Sign extend both operands to the same width m. The sum of two m-bit
+// values always fits in m+1 bits, so the top bit is just the sum of the two
+// sign bits and the carry out.
+signed_int add(const signed_int &n0, const signed_int &n1, int style, int threads)
+{
+	int w = fixed_width(n0, n1);
+	size_t m = w > 0 ? w : std::max(n0.bits.size(), n1.bits.size());
+	signed_int a = n0, b = n1;
+	a.resize(m);
+	b.resize(m);
+	signed_int result = add(a, b, cover(0), style, threads, w == 0);
+	if (w == 0)
+		result.bits.back() = full_sum(a.extend(), b.extend(), result.bits.back());
+	result.fixed = w;
 	return result;
 }
 
-signed_int operator-(const signed_int &n0, const signed_int &n1)
+signed_int subtract(const signed_int &n0, const signed_int &n1, int style, int threads)
 {
-	signed_int result;
-	cover carry = 1, inf;
-	int m = (int)std::min(n0.bits.size(), n1.bits.size());
-	for (int i = 0; i < m; i++)
-	{
-		result.bits.push_back((n0.bits[i]&n1.bits[i]&~carry) | (~n0.bits[i]&~n1.bits[i]&~carry) | (~n0.bits[i]&n1.bits[i]&carry));
-		carry = (n0.bits[i]&~n1.bits[i]) | (n0.bits[i]&carry) | (~n1.bits[i]&carry);
-	}
-	for (int i = m; i < (int)n0.bits.size(); i++)
+	int w = fixed_width(n0, n1);
+	size_t m = w > 0 ? w : std::max(n0.bits.size(), n1.bits.size());
+	signed_int a = n0, b = n1;
+	a.resize(m);
+	b.resize(m);
+	signed_int nb = ~b;
+	signed_int result = add(a, nb, cover(1), style, threads, w == 0);
+	if (w == 0)
+		result.bits.back() = full_sum(a.extend(), nb.extend(), result.bits.back());
+	result.fixed = w;
+	return result;
+}
+
+signed_int operator*(const signed_int &n0, const signed_int &n1)
+{
+	return multiply(n0, n1, DADDA_TREE);
+}
+
+// Radix-4 Booth recoding. Each pair of bits of n1 along with the bit below
+// it selects a digit in -2..2, so there are half as many partial products as
+// bits in n1. The partial product d*n0 needs m+2 bits. Rather than sign
+// extend it, its sign bit s is written as ~s - 1 and the -1 of every partial
+// product is collected into a single constant.
+//
+// With a fixed width w, both operands are first truncated to w bits, which
+// does not change the product modulo 2^w.
+signed_int multiply(const signed_int &n0, const signed_int &n1, int style, int adder, bool minimize, int threads)
+{
+	int w = fixed_width(n0, n1);
+	signed_int x = n0, y = n1;
+	if (w > 0 and (int)x.bits.size() > w)
+		x.bits.resize(w);
+	if (w > 0 and (int)y.bits.size() > w)
+		y.bits.resize(w);
+
+	int m = (int)x.bits.size();
+	int n = (int)y.bits.size();
+	if (m == 0 or n == 0)
 	{
-		result.bits.push_back((n0.bits[i]&n1.extend()&~carry) | (~n0.bits[i]&~n1.extend()&~carry) | (~n0.bits[i]&n1.extend()&carry));
-		carry = (n0.bits[i]&~n1.extend()) | (n0.bits[i]&carry) | (~n1.extend()&carry);
+		signed_int result(0l);
+		result.fixed = w;
+		return result;
 	}
-	for (int i = m; i < (int)n1.bits.size(); i++)
+
+	int width = m+n;
+	if (w > 0)
+		width = std::min(width, w);
+
+	unsigned long a, b;
+	if (m+n <= 64 and x.to_constant(&a) and y.to_constant(&b))
 	{
-		result.bits.push_back((n0.extend()&n1.bits[i]&~carry) | (~n0.extend()&~n1.bits[i]&~carry) | (~n0.extend()&n1.bits[i]&carry));
-		carry = (n0.extend()&~n1.bits[i]) | (n0.extend()&carry) | (~n1.bits[i]&carry);
+		// sign extend both values to 64 bits
+		a = (unsigned long)((long)(a << (64-m)) >> (64-m));
+		b = (unsigned long)((long)(b << (64-n)) >> (64-n));
+		signed_int result = from_constant(a*b, width);
+		result.fixed = w;
+		return result;
 	}
 
-	inf = (n0.extend()&~n1.extend()) | (n0.extend()&carry) | (~n1.extend()&carry);
-	while (inf != carry)
+	int digits = (n+1)/2;
+	x.resize(m+2);
+	y.resize(2*digits);
+
+	vector<vector<cover> > columns(width);
+	for (int j = 0; j < digits; j++)
 	{
-		result.bits.push_back((n0.extend()&n1.extend()&~carry) | (~n0.extend()&~n1.extend()&~carry) | (~n0.extend()&n1.extend()&carry));
-		carry = inf;
-		inf = (n0.extend()&~n1.extend()) | (n0.extend()&carry) | (~n1.extend()&carry);
+		cover lo = j > 0 ? y.bits[2*j-1] : cover(0);
+		cover mid = y.bits[2*j];
+		cover hi = y.bits[2*j+1];
+
+		cover one = mid ^ lo;
+		cover two = (hi ^ mid) & xnor(mid, lo);
+
+		for (int i = 0; i < m+2 and 2*j+i < width; i++)
+		{
+			cover bit = one&x.bits[i];
+			if (i > 0)
+				bit |= two&x.bits[i-1];
+			if (i == m+1)
+				bit = xnor(bit, hi);
+			else
+				bit = bit ^ hi;
+			columns[2*j+i].push_back(bit);
+		}
+		// complete the two's complement negation
+		if (2*j < width)
+			columns[2*j].push_back(hi);
 	}
 
-	return result;
-}
+	// The constant is -sum(2^(m+1+2j)). Its lowest bit is at m+1, and above
+	// that it is the complement of the sum.
+	for (int i = m+1; i < width; i++)
+		if (i == m+1 or (i-m-1)%2 == 1 or i > m+1+2*(digits-1))
+			columns[i].push_back(cover(1));
 
-signed_int operator*(const signed_int &n0, const signed_int &n1)
-{
-	signed_int result;
-	for (int i = 0; i < (int)n1.bits.size(); i++)
-		result = result + ((n0&n1.bits[i]) << i);
+	signed_int result = carry_save(columns, style, adder, minimize, threads);
+	result.fixed = w;
 	return result;
 }
 
@@ -163,8 +264,8 @@ signed_int operator/(const signed_int &n0, const signed_int &n1)
 	result.bits.resize(n0.bits.size(), cover(0));
 
 	// take the absolute value of each signed_int
-	signed_int m0 = (n0.extend()&~n0) | (~n0.extend()&n0);
-	signed_int m1 = (n1.extend()&~n1) | (~n1.extend()&n1);
+	signed_int m0 = n0.extend() ^ n0;
+	signed_int m1 = n1.extend() ^ n1;
 
 	int s = ((int)n0.bits.size())-1;
 	for (int i = s; i >= 0; i--)
@@ -182,33 +283,83 @@ signed_int operator/(const signed_int &n0, const signed_int &n1)
 	return result;
 }
 
-cover operator<(const signed_int &n0, const signed_int &n1)
+// Give a bitwise result the fixed width w, zero or sign extending it or
+// dropping the bits above w.
+static signed_int fixed_result(const bitset &n, int w)
 {
-	cover n0n_n1p = n0.extend()&~n1.extend();
-	cover n0s_n1s = (n0.extend()&n1.extend()) | (~n0.extend()&~n1.extend());
-	cover disjunction(0);
-	cover conjunction(1);
-
-	// take the absolute value of each signed_int
-	signed_int m0 = (n0.extend()&~n0) | (~n0.extend()&n0);
-	signed_int m1 = (n1.extend()&~n1) | (~n1.extend()&n1);
-
-	// if n1 has more bits than n0, all it takes is one of those bits
-	// to be set for n0 to be less than n1
-	for (int i = (int)m1.bits.size()-1; i >= (int)m0.bits.size(); i--)
-		disjunction |= m1.bits[i];
-	// if n0 has more bits than n1, then every bit must be 0
-	for (int i = (int)m0.bits.size()-1; i >= (int)m1.bits.size(); i--)
-		conjunction &= ~m0.bits[i];
-
-	int m = (int)std::min((int)m0.bits.size()-1, (int)m1.bits.size()-1);
-	for (int i = m; i >= 0; i--)
+	signed_int result(n);
+	if (w > 0)
 	{
-		disjunction |= ~m0.bits[i]&m1.bits[i]&conjunction;
-		conjunction &= (m0.bits[i]&m1.bits[i]) | (~m0.bits[i]&~m1.bits[i]);
+		result.resize(w);
+		result.fixed = w;
 	}
+	return result;
+}
+
+signed_int operator~(const signed_int &n)
+{
+	signed_int a = n;
+	if (a.fixed > 0)
+		a.resize(a.fixed);
+	const bitset &b = a;
+	return fixed_result(~b, n.fixed);
+}
+
+template <typename T> requires std::same_as<T, signed_int>
+T operator&(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a & b, fixed_width(n0, n1));
+}
+
+template signed_int operator&<signed_int>(const signed_int &n0, const signed_int &n1);
+
+template <typename T> requires std::same_as<T, signed_int>
+T operator|(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a | b, fixed_width(n0, n1));
+}
+
+template signed_int operator|<signed_int>(const signed_int &n0, const signed_int &n1);
+
+template <typename T> requires std::same_as<T, signed_int>
+T operator^(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a ^ b, fixed_width(n0, n1));
+}
+
+template signed_int operator^<signed_int>(const signed_int &n0, const signed_int &n1);
+
+signed_int operator<<(const signed_int &n, int s)
+{
+	const bitset &a = n;
+	return fixed_result(a << s, n.fixed);
+}
+
+signed_int operator>>(const signed_int &n, int s)
+{
+	const bitset &a = n;
+	return fixed_result(a >> s, n.fixed);
+}
+
+// n0 < n1 is the sign of n0 - n1 computed with one extra bit, which never
+// overflows. Only the carry chain of the subtraction is needed.
+cover operator<(const signed_int &n0, const signed_int &n1)
+{
+	int w = fixed_width(n0, n1);
+	size_t m = w > 0 ? w : std::max(std::max(n0.bits.size(), n1.bits.size()), (size_t)1);
+	signed_int a = n0, b = n1;
+	a.resize(m);
+	b.resize(m);
+	b = ~b;
+
+	cover carry = 1;
+	for (int i = 0; i < (int)m; i++)
+		carry = full_carry(a.bits[i], b.bits[i], carry);
 
-	cover result = n0n_n1p | (n0s_n1s&disjunction);
+	cover result = full_sum(a.extend(), b.extend(), carry);
 	result.espresso();
 	return result;
 }
@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <concepts>
+
 #include <boolean/bitset.h>
+#include <boolean/adder.h>
+#include <boolean/multiplier.h>
 
 namespace boolean
 {
@@ -21,6 +25,12 @@ struct signed_int : bitset
 	signed_int(const signed_int &n);
 	~signed_int();
 
+	// When nonzero, arithmetic on this value is computed modulo 2^fixed and
+	// the bits above that are never built, see unsigned_int::fixed.
+	int fixed;
+
+	signed_int &fix(int width);
+
 	cover extend() const;
 
 	signed_int &operator+=(const signed_int &n);
@@ -28,6 +38,11 @@ struct signed_int : bitset
 	signed_int &operator*=(const signed_int &n);
 	signed_int &operator/=(const signed_int &n);
 	//signed_int &operator%=(const signed_int &n);
+	signed_int &operator&=(const signed_int &n);
+	signed_int &operator|=(const signed_int &n);
+	signed_int &operator^=(const signed_int &n);
+	signed_int &operator<<=(int s);
+	signed_int &operator>>=(int s);
 };
 
 signed_int operator-(const signed_int &n);
@@ -36,6 +51,27 @@ signed_int operator-(const signed_int &n0, const signed_int &n1);
 signed_int operator*(const signed_int &n0, const signed_int &n1);
 signed_int operator/(const signed_int &n0, const signed_int &n1);
 
+// The bitwise operators keep the fixed width of their operands, dropping the
+// bits shifted past it. The binary ones only match two signed_ints, anything
+// mixed with a plain bitset or cover goes to the bitset operators instead.
+signed_int operator~(const signed_int &n);
+template <typename T> requires std::same_as<T, signed_int>
+T operator&(const T &n0, const T &n1);
+template <typename T> requires std::same_as<T, signed_int>
+T operator|(const T &n0, const T &n1);
+template <typename T> requires std::same_as<T, signed_int>
+T operator^(const T &n0, const T &n1);
+signed_int operator<<(const signed_int &n, int s);
+signed_int operator>>(const signed_int &n, int s);
+
+// operator+ and operator- with a selectable adder, see adder.h
+signed_int add(const signed_int &n0, const signed_int &n1, int style, int threads = 1);
+signed_int subtract(const signed_int &n0, const signed_int &n1, int style, int threads = 1);
+
+// operator* with a selectable partial product reduction, see multiplier.h.
+// The result is exactly n0.bits.size() + n1.bits.size() bits wide.
+signed_int multiply(const signed_int &n0, const signed_int &n1, int style, int adder = RIPPLE_CARRY, bool minimize = false, int threads = 1);
+
 cover operator<(const signed_int &n0, const signed_int &n1);
 cover operator>(const signed_int &n0, const signed_int &n1);
 cover operator<=(const signed_int &n0, const signed_int &n1);
@@ -0,0 +1,83 @@
+/*
+ * task.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/task.h>
+
+#include <cstddef>
+
+namespace boolean
+{
+
+static thread_local task *current = NULL;
+
+task::task()
+{
+	cancelled = false;
+	parent = NULL;
+	budget = -1;
+}
+
+task::task(task *parent, long budget)
+{
+	cancelled = false;
+	this->parent = parent;
+	this->budget = budget;
+	deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budget < 0 ? 0 : budget);
+}
+
+task::~task()
+{
+}
+
+void task::cancel()
+{
+	cancelled.store(true, std::memory_order_relaxed);
+}
+
+bool task::is_cancelled() const
+{
+	return cancelled.load(std::memory_order_relaxed)
+		or (parent != NULL and parent->is_cancelled())
+		or (budget >= 0 and std::chrono::steady_clock::now() >= deadline);
+}
+
+void task::report(const char *phase, int done, int total) const
+{
+	if (progress)
+		progress(phase, done, total);
+	else if (parent != NULL)
+		parent->report(phase, done, total);
+}
+
+task_scope::task_scope(task *t)
+{
+	previous = current;
+	current = t;
+}
+
+task_scope::~task_scope()
+{
+	current = previous;
+}
+
+task *current_task()
+{
+	return current;
+}
+
+bool is_cancelled()
+{
+	return current != NULL and current->is_cancelled();
+}
+
+void report_progress(const char *phase, int done, int total)
+{
+	if (current != NULL)
+		current->report(phase, done, total);
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * task.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace boolean
+{
+
+// A handle on a long running operation, shared between the thread that
+// started it and the code doing the work. Cancellation is cooperative: the
+// expensive recursions check the current task at their boundaries and unwind
+// as soon as they see it was cancelled. Once a task is cancelled the result
+// of the operation is unspecified unless that operation says otherwise, and
+// the caller should discard it.
+struct task
+{
+	task();
+	// A task that also counts as cancelled once parent is, or once budget
+	// microseconds have passed. A negative budget never runs out, and
+	// progress is passed on to the parent.
+	task(task *parent, long budget);
+	~task();
+
+	std::atomic<bool> cancelled;
+	task *parent;
+	long budget;
+	std::chrono::steady_clock::time_point deadline;
+
+	// Called with the name of the current phase and how far along it is,
+	// total is -1 when it isn't known. This may be called from any of the
+	// threads working on the operation.
+	std::function<void(const char *phase, int done, int total)> progress;
+
+	// Safe to call from any thread.
+	void cancel();
+	bool is_cancelled() const;
+	void report(const char *phase, int done, int total) const;
+};
+
+// Makes t the current task of this thread until the scope ends. Scopes nest,
+// and fork_join() and parallel_for() carry the current task over to the
+// threads they start.
+struct task_scope
+{
+	task_scope(task *t);
+	~task_scope();
+
+	task *previous;
+};
+
+// The current task of this thread, or NULL if there is none.
+task *current_task();
+
+// Whether the current task has been cancelled. Without a task this is
+// always false, so the checks cost a thread local load.
+bool is_cancelled();
+void report_progress(const char *phase, int done, int total = -1);
+
+}
@@ -0,0 +1,292 @@
+/*
+ * trace.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/trace.h>
+#include <boolean/binary.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace boolean
+{
+
+// A trace file is this header and then the records, each one a word count
+// followed by that many words:
+//   kind, effort, iterations, budget (two words), width, offset, threads,
+//   hide count, the hidden uids, and then the covers as the image that
+//   write_binary() writes for a bitset.
+static const uint64_t trace_magic = 0x314352544C4F4F42ull;
+static const uint32_t trace_version = 2;
+
+struct trace_header
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+};
+
+static std::atomic<bool> tracing(false);
+static std::mutex writer;
+static FILE *output = NULL;
+static thread_local int depth = 0;
+
+trace_record::trace_record()
+{
+	kind = TRACE_COMPLEMENT;
+	width = 0;
+	offset = 0;
+	threads = 1;
+}
+
+trace_record::trace_record(int kind, const cover &F)
+{
+	this->kind = kind;
+	covers.push_back(F);
+	width = 0;
+	offset = 0;
+	threads = 1;
+}
+
+trace_record::trace_record(int kind, const cover &F, const cover &D, const espresso_options &options)
+{
+	this->kind = kind;
+	covers.push_back(F);
+	covers.push_back(D);
+	this->options = options;
+	width = 0;
+	offset = 0;
+	threads = 1;
+}
+
+trace_record::trace_record(int kind, const cover &F, const cover &D, const cover &R, const espresso_options &options)
+{
+	this->kind = kind;
+	covers.push_back(F);
+	covers.push_back(D);
+	covers.push_back(R);
+	this->options = options;
+	width = 0;
+	offset = 0;
+	threads = 1;
+}
+
+trace_record::trace_record(int kind, const bitset &b, int width, int offset, const vector<int> &hide, int threads)
+{
+	this->kind = kind;
+	covers = b.bits;
+	this->width = width;
+	this->offset = offset;
+	this->hide = hide;
+	this->threads = threads;
+}
+
+trace_record::~trace_record()
+{
+}
+
+bool trace_begin(const char *path)
+{
+	std::lock_guard<std::mutex> guard(writer);
+	if (output != NULL)
+		fclose(output);
+
+	output = fopen(path, "wb");
+	if (output == NULL) {
+		tracing.store(false);
+		return false;
+	}
+
+	trace_header h;
+	h.magic = trace_magic;
+	h.version = trace_version;
+	h.reserved = 0;
+	if (fwrite(&h, sizeof(h), 1, output) != 1) {
+		fclose(output);
+		output = NULL;
+		tracing.store(false);
+		return false;
+	}
+
+	tracing.store(true);
+	return true;
+}
+
+void trace_end()
+{
+	std::lock_guard<std::mutex> guard(writer);
+	tracing.store(false);
+	if (output != NULL)
+		fclose(output);
+	output = NULL;
+}
+
+bool is_tracing()
+{
+	return tracing.load(std::memory_order_relaxed);
+}
+
+trace_scope::trace_scope()
+{
+	active = tracing.load(std::memory_order_relaxed);
+	outer = active and depth == 0;
+	if (active)
+		depth++;
+}
+
+trace_scope::trace_scope(bool nested)
+{
+	active = nested;
+	outer = false;
+	if (active)
+		depth++;
+}
+
+trace_scope::~trace_scope()
+{
+	if (active)
+		depth--;
+}
+
+bool in_traced_call()
+{
+	return depth > 0;
+}
+
+void trace(const trace_record &record)
+{
+	if (!is_tracing())
+		return;
+
+	// serialize outside the lock so that threads only wait on the write
+	vector<uint32_t> buffer;
+	buffer.push_back(0);
+	buffer.push_back(record.kind);
+	buffer.push_back(record.options.effort);
+	buffer.push_back(record.options.iterations);
+	buffer.push_back((uint32_t)((uint64_t)(int64_t)record.options.budget));
+	buffer.push_back((uint32_t)((uint64_t)(int64_t)record.options.budget >> 32));
+	buffer.push_back(record.width);
+	buffer.push_back(record.offset);
+	buffer.push_back(record.threads);
+	buffer.push_back(record.hide.size());
+	buffer.insert(buffer.end(), record.hide.begin(), record.hide.end());
+
+	// the covers are the same image write_binary() writes for a bitset
+	string image;
+	format_binary(record.covers, image);
+	size_t at = buffer.size();
+	buffer.resize(at + image.size()/sizeof(uint32_t));
+	memcpy(buffer.data()+at, image.data(), image.size());
+	buffer[0] = buffer.size()-1;
+
+	std::lock_guard<std::mutex> guard(writer);
+	if (output != NULL)
+		fwrite(buffer.data(), sizeof(uint32_t), buffer.size(), output);
+}
+
+bool read_trace(const char *path, vector<trace_record> *result)
+{
+	FILE *fptr = fopen(path, "rb");
+	if (fptr == NULL)
+		return false;
+
+	trace_header h;
+	if (fread(&h, sizeof(h), 1, fptr) != 1 or h.magic != trace_magic or h.version != trace_version) {
+		fclose(fptr);
+		return false;
+	}
+
+	uint32_t length;
+	vector<uint32_t> buffer;
+	while (fread(&length, sizeof(length), 1, fptr) == 1) {
+		buffer.resize(length);
+		if (fread(buffer.data(), sizeof(uint32_t), length, fptr) != length) {
+			fclose(fptr);
+			return false;
+		}
+
+		// each field is bounds checked against the record length
+		const uint32_t *i = buffer.data(), *end = buffer.data() + length;
+		if (end - i < 9) {
+			fclose(fptr);
+			return false;
+		}
+
+		trace_record r;
+		r.kind = *i++;
+		r.options.effort = (int)*i++;
+		r.options.iterations = (int)*i++;
+		uint64_t budget = *i++;
+		budget |= (uint64_t)*i++ << 32;
+		r.options.budget = (long)(int64_t)budget;
+		r.width = (int)*i++;
+		r.offset = (int)*i++;
+		r.threads = (int)*i++;
+		uint32_t hide = *i++;
+
+		bool ok = (uint32_t)(end - i) >= hide;
+		if (ok) {
+			r.hide.assign(i, i+hide);
+			i += hide;
+			ok = parse_binary((const char*)i, (end - i)*sizeof(uint32_t), &r.covers);
+			i = end;
+		}
+
+		if (!ok or i != end) {
+			fclose(fptr);
+			return false;
+		}
+		result->push_back(r);
+	}
+
+	fclose(fptr);
+	return true;
+}
+
+long replay(const trace_record &record)
+{
+	auto start = std::chrono::steady_clock::now();
+	switch (record.kind) {
+	case TRACE_ESPRESSO:
+		if (record.covers.size() == 3) {
+			cover F = record.covers[0];
+			espresso(F, record.covers[1], record.covers[2], record.options);
+		}
+		break;
+	case TRACE_ESPRESSO_NOOFFSET:
+		if (record.covers.size() == 2) {
+			cover F = record.covers[0];
+			espresso(F, record.covers[1], record.options);
+		}
+		break;
+	case TRACE_COMPLEMENT:
+		if (record.covers.size() == 1)
+			~record.covers[0];
+		break;
+	case TRACE_TAUTOLOGY:
+		if (record.covers.size() == 1)
+			record.covers[0].is_tautology();
+		break;
+	case TRACE_HFACTOR:
+	case TRACE_XFACTOR: {
+		bitset b;
+		b.bits = record.covers;
+		factor_table factors;
+		if (record.kind == TRACE_HFACTOR)
+			b.decompose_hfactor(factors, record.width, record.offset, record.hide, record.threads);
+		else
+			b.decompose_xfactor(factors, record.width, record.offset, record.hide, record.threads);
+		break;
+	}
+	}
+	return (long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
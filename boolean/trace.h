@@ -0,0 +1,91 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/bitset.h>
+
+#include <stdint.h>
+
+namespace boolean
+{
+
+// The calls that can be traced.
+enum trace_kind
+{
+	// espresso(F, D, R, options), covers are F, D and R
+	TRACE_ESPRESSO = 0,
+	// espresso(F, D, options), covers are F and D
+	TRACE_ESPRESSO_NOOFFSET = 1,
+	// ~F
+	TRACE_COMPLEMENT = 2,
+	// F.is_tautology()
+	TRACE_TAUTOLOGY = 3,
+	// decompose_hfactor() and decompose_xfactor(), covers are the bits
+	TRACE_HFACTOR = 4,
+	TRACE_XFACTOR = 5
+};
+
+// The inputs of one traced call, enough to make the call again.
+struct trace_record
+{
+	trace_record();
+	trace_record(int kind, const cover &F);
+	trace_record(int kind, const cover &F, const cover &D, const espresso_options &options);
+	trace_record(int kind, const cover &F, const cover &D, const cover &R, const espresso_options &options);
+	trace_record(int kind, const bitset &b, int width, int offset, const vector<int> &hide, int threads);
+	~trace_record();
+
+	int kind;
+	vector<cover> covers;
+
+	// only for espresso
+	espresso_options options;
+
+	// only for the decompositions
+	int width;
+	int offset;
+	vector<int> hide;
+	int threads;
+};
+
+// Start appending the inputs of every traced call to a trace file, replacing
+// anything already there. Returns false if the file can't be written.
+// Tracing is process wide, and calls from any thread are recorded.
+bool trace_begin(const char *path);
+void trace_end();
+bool is_tracing();
+
+// Put at the top of a traced call. Only the outermost traced call is
+// recorded, the complements and tautology checks that espresso makes on its
+// own are part of the espresso call. fork_join() and parallel_for() carry
+// this over to the threads they start. Without tracing this is one relaxed
+// load.
+struct trace_scope
+{
+	trace_scope();
+	trace_scope(bool nested);
+	~trace_scope();
+
+	bool active;
+	bool outer;
+};
+
+// Whether this thread is inside a traced call.
+bool in_traced_call();
+
+// Append a record to the trace if tracing.
+void trace(const trace_record &record);
+
+// Read every record in a trace file, false if it isn't a trace file or is
+// cut off in the middle of a record.
+bool read_trace(const char *path, vector<trace_record> *result);
+
+// Make the call again and return how long it took in microseconds.
+long replay(const trace_record &record);
+
+}
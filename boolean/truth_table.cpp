@@ -0,0 +1,279 @@
+/*
+ * truth_table.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/truth_table.h>
+
+#include <algorithm>
+
+namespace boolean
+{
+
+// The minterms in which variable i < 6 is 1, repeated across a word
+static const uint64_t literal[6] = {
+	0xAAAAAAAAAAAAAAAAul,
+	0xCCCCCCCCCCCCCCCCul,
+	0xF0F0F0F0F0F0F0F0ul,
+	0xFF00FF00FF00FF00ul,
+	0xFFFF0000FFFF0000ul,
+	0xFFFFFFFF00000000ul
+};
+
+// The bits of a word that are used by a table of vars variables
+static uint64_t used(int vars)
+{
+	return vars >= 6 ? ~0ul : (1ul << (1 << vars)) - 1;
+}
+
+truth_table::truth_table()
+{
+	vars = 0;
+	words.resize(1, 0);
+}
+
+truth_table::truth_table(int vars, int val)
+{
+	this->vars = vars;
+	words.resize(vars > 6 ? 1ul << (vars-6) : 1, val ? used(vars) : 0);
+}
+
+truth_table::truth_table(const cover &s, const vector<int> &support)
+{
+	vars = (int)support.size();
+	words.resize(vars > 6 ? 1ul << (vars-6) : 1, 0);
+
+	vector<uint64_t> term(words.size());
+	for (int i = 0; i < s.size(); i++)
+	{
+		if (s[i].is_null())
+			continue;
+
+		fill(term.begin(), term.end(), used(vars));
+		for (int v = 0; v < vars; v++)
+		{
+			int val = s[i].get(support[v]);
+			if (val == 2)
+				continue;
+
+			if (v < 6)
+			{
+				uint64_t mask = val ? literal[v] : ~literal[v];
+				for (int w = 0; w < (int)term.size(); w++)
+					term[w] &= mask;
+			}
+			else
+			{
+				for (int w = 0; w < (int)term.size(); w++)
+					if (((w >> (v-6)) & 1) != val)
+						term[w] = 0;
+			}
+		}
+
+		for (int w = 0; w < (int)words.size(); w++)
+			words[w] |= term[w];
+	}
+}
+
+truth_table::~truth_table()
+{
+}
+
+bool truth_table::is_tautology() const
+{
+	uint64_t all = used(vars);
+	for (int w = 0; w < (int)words.size(); w++)
+		if (words[w] != all)
+			return false;
+	return true;
+}
+
+bool truth_table::is_null() const
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		if (words[w] != 0)
+			return false;
+	return true;
+}
+
+bool truth_table::is_subset_of(const truth_table &t) const
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		if ((words[w] & ~t.words[w]) != 0)
+			return false;
+	return true;
+}
+
+// Shannon expansion from the top variable down. The two halves of a table
+// are contiguous, so this never copies a table. Cubes found in both halves
+// don't depend on the split variable.
+static void to_cubes(const uint64_t *words, int vars, const vector<int> &support, vector<cube> &result)
+{
+	if (vars > 6)
+	{
+		size_t n = 1ul << (vars-6);
+		bool zero = true, one = true;
+		for (size_t w = 0; w < n and (zero or one); w++)
+		{
+			zero = zero and words[w] == 0;
+			one = one and words[w] == ~0ul;
+		}
+		if (zero)
+			return;
+		if (one)
+		{
+			result.push_back(cube());
+			return;
+		}
+	}
+	else
+	{
+		uint64_t all = used(vars);
+		if ((words[0] & all) == 0)
+			return;
+		if ((words[0] & all) == all)
+		{
+			result.push_back(cube());
+			return;
+		}
+	}
+
+	int var = vars-1;
+	vector<cube> s0, s1;
+	if (vars > 6)
+	{
+		size_t half = 1ul << (vars-7);
+		to_cubes(words, vars-1, support, s0);
+		to_cubes(words + half, vars-1, support, s1);
+	}
+	else
+	{
+		int half = 1 << var;
+		uint64_t lo = words[0] & used(var);
+		uint64_t hi = (words[0] >> half) & used(var);
+		to_cubes(&lo, var, support, s0);
+		to_cubes(&hi, var, support, s1);
+	}
+
+	merge_shannon(support[var], s0, s1, result);
+}
+
+cover truth_table::to_cover(const vector<int> &support) const
+{
+	cover result;
+	to_cubes(words.data(), vars, support, result.cubes);
+	result.minimize();
+	return result;
+}
+
+truth_table &truth_table::operator&=(const truth_table &t)
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		words[w] &= t.words[w];
+	return *this;
+}
+
+truth_table &truth_table::operator|=(const truth_table &t)
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		words[w] |= t.words[w];
+	return *this;
+}
+
+truth_table &truth_table::operator^=(const truth_table &t)
+{
+	for (int w = 0; w < (int)words.size(); w++)
+		words[w] ^= t.words[w];
+	return *this;
+}
+
+truth_table operator~(truth_table t)
+{
+	uint64_t all = used(t.vars);
+	for (int w = 0; w < (int)t.words.size(); w++)
+		t.words[w] = ~t.words[w] & all;
+	return t;
+}
+
+truth_table operator&(truth_table t0, const truth_table &t1)
+{
+	t0 &= t1;
+	return t0;
+}
+
+truth_table operator|(truth_table t0, const truth_table &t1)
+{
+	t0 |= t1;
+	return t0;
+}
+
+truth_table operator^(truth_table t0, const truth_table &t1)
+{
+	t0 ^= t1;
+	return t0;
+}
+
+bool operator==(const truth_table &t0, const truth_table &t1)
+{
+	return t0.vars == t1.vars and t0.words == t1.words;
+}
+
+bool operator!=(const truth_table &t0, const truth_table &t1)
+{
+	return not (t0 == t1);
+}
+
+truth_table cofactor(const truth_table &t, int var, int val)
+{
+	truth_table result = t;
+	if (var < 6)
+	{
+		int shift = 1 << var;
+		for (int w = 0; w < (int)result.words.size(); w++)
+		{
+			uint64_t x = result.words[w];
+			if (val)
+			{
+				x &= literal[var];
+				x |= x >> shift;
+			}
+			else
+			{
+				x &= ~literal[var];
+				x |= x << shift;
+			}
+			result.words[w] = x & used(t.vars);
+		}
+	}
+	else
+	{
+		int stride = 1 << (var-6);
+		for (int w = 0; w < (int)result.words.size(); w++)
+			if ((w & stride) == 0)
+			{
+				uint64_t x = val ? result.words[w+stride] : result.words[w];
+				result.words[w] = x;
+				result.words[w+stride] = x;
+			}
+	}
+	return result;
+}
+
+bool small_support(const cover &s1, const cover &s2, vector<int> *support, int limit)
+{
+	support->clear();
+	s1.vars(support);
+	if ((int)support->size() > limit)
+		return false;
+
+	vector<int> other;
+	s2.vars(&other);
+	support->insert(support->end(), other.begin(), other.end());
+	sort(support->begin(), support->end());
+	support->resize(unique(support->begin(), support->end()) - support->begin());
+	return (int)support->size() <= limit;
+}
+
+}
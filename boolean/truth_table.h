@@ -0,0 +1,62 @@
+/*
+ * truth_table.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#pragma once
+
+#include <boolean/cover.h>
+
+#include <cstdint>
+
+namespace boolean
+{
+
+// A function of a small number of variables stored as 2^vars bits, bit m
+// holding the value of the function on minterm m. A cover is converted by
+// mapping its support onto variables 0..n-1, so the size of the table only
+// depends on the number of variables the cover actually uses. Every
+// operation is a loop over 64 bit words that the compiler vectorizes.
+struct truth_table
+{
+	truth_table();
+	truth_table(int vars, int val = 0);
+	truth_table(const cover &s, const vector<int> &support);
+	~truth_table();
+
+	// The largest support for which cover operations switch to a truth
+	// table, 2^16 bits is 8kB per table.
+	static const int max_support = 16;
+
+	int vars;
+	vector<uint64_t> words;
+
+	bool is_tautology() const;
+	bool is_null() const;
+	bool is_subset_of(const truth_table &t) const;
+
+	cover to_cover(const vector<int> &support) const;
+
+	truth_table &operator&=(const truth_table &t);
+	truth_table &operator|=(const truth_table &t);
+	truth_table &operator^=(const truth_table &t);
+};
+
+truth_table operator~(truth_table t);
+truth_table operator&(truth_table t0, const truth_table &t1);
+truth_table operator|(truth_table t0, const truth_table &t1);
+truth_table operator^(truth_table t0, const truth_table &t1);
+
+bool operator==(const truth_table &t0, const truth_table &t1);
+bool operator!=(const truth_table &t0, const truth_table &t1);
+
+// Restrict variable var to val. The result still has the same variables,
+// but no longer depends on var.
+truth_table cofactor(const truth_table &t, int var, int val);
+
+// The combined support of both covers, or false if it is larger than limit.
+bool small_support(const cover &s1, const cover &s2, vector<int> *support, int limit = truth_table::max_support);
+
+}
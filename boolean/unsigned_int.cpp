@@ -10,22 +10,52 @@
 namespace boolean
 {
 
-unsigned_int::unsigned_int() { }
-unsigned_int::unsigned_int(int width, int offset) : bitset(width, offset) { }
+unsigned_int::unsigned_int() { fixed = 0; }
+unsigned_int::unsigned_int(int width, int offset) : bitset(width, offset) { fixed = 0; }
 
 unsigned_int::unsigned_int(unsigned long value)
 {
+	fixed = 0;
 	while (value > 0) {
 		bits.push_back(cover(value & 1));
 		value >>= 1;
 	}
 }
 
-unsigned_int::unsigned_int(const cover &c) : bitset(c) { }
-unsigned_int::unsigned_int(const bitset &n) : bitset(n) { }
-unsigned_int::unsigned_int(const unsigned_int &n) : bitset(n) { }
+unsigned_int::unsigned_int(const cover &c) : bitset(c) { fixed = 0; }
+unsigned_int::unsigned_int(const bitset &n) : bitset(n) { fixed = 0; }
+unsigned_int::unsigned_int(const unsigned_int &n) : bitset(n) { fixed = n.fixed; }
 unsigned_int::~unsigned_int() { }
 
+// Truncate or zero extend this value to width bits and keep all further
+// arithmetic on it at that width.
+unsigned_int &unsigned_int::fix(int width)
+{
+	fixed = width;
+	resize(width);
+	return *this;
+}
+
+static int fixed_width(const unsigned_int &n0, const unsigned_int &n1)
+{
+	return std::max(n0.fixed, n1.fixed);
+}
+
+// Both operands truncated to the fixed width of the result, if there is one
+static void truncate(const unsigned_int &n0, const unsigned_int &n1, unsigned_int &a, unsigned_int &b)
+{
+	a = n0;
+	b = n1;
+	int w = fixed_width(n0, n1);
+	if (w > 0)
+	{
+		if ((int)a.bits.size() > w)
+			a.bits.resize(w);
+		if ((int)b.bits.size() > w)
+			b.bits.resize(w);
+	}
+}
+
 unsigned_int &unsigned_int::operator+=(const unsigned_int &n)
 {
 	*this = *this + n;
@@ -50,92 +80,205 @@ unsigned_int &unsigned_int::operator/=(const unsigned_int &n)
 	return *this;
 }
 
-/*unsigned_int &unsigned_int::operator%=(const unsigned_int &n)
+unsigned_int &unsigned_int::operator%=(const unsigned_int &n)
 {
 	*this = *this % n;
 	return *this;
-}*/
+}
+
+unsigned_int &unsigned_int::operator&=(const unsigned_int &n)
+{
+	*this = *this & n;
+	return *this;
+}
+
+unsigned_int &unsigned_int::operator|=(const unsigned_int &n)
+{
+	*this = *this | n;
+	return *this;
+}
+
+unsigned_int &unsigned_int::operator^=(const unsigned_int &n)
+{
+	*this = *this ^ n;
+	return *this;
+}
+
+unsigned_int &unsigned_int::operator<<=(int s)
+{
+	*this = *this << s;
+	return *this;
+}
+
+unsigned_int &unsigned_int::operator>>=(int s)
+{
+	*this = *this >> s;
+	return *this;
+}
 
 unsigned_int operator+(const unsigned_int &n0, const unsigned_int &n1)
 {
-	unsigned_int result;
-	cover carry = 0, inf;
-	int m = (int)std::min(n0.bits.size(), n1.bits.size());
-	for (int i = 0; i < m; i++)
-	{
-		result.bits.push_back((n0.bits[i]&~n1.bits[i]&~carry) | (~n0.bits[i]&n1.bits[i]&~carry) | (~n0.bits[i]&~n1.bits[i]&carry));
-		carry = (n0.bits[i]&n1.bits[i]) | (n0.bits[i]&carry) | (n1.bits[i]&carry);
-	}
-	for (int i = m; i < (int)n0.bits.size(); i++)
-	{
-		result.bits.push_back((n0.bits[i]&~carry) | (~n0.bits[i]&carry));
-		carry = n0.bits[i]&carry;
-	}
-	for (int i = m; i < (int)n1.bits.size(); i++)
-	{
-		result.bits.push_back((n1.bits[i]&~carry) | (~n1.bits[i]&carry));
-		carry = n1.bits[i]&carry;
-	}
-	result.bits.push_back(carry);
+	return add(n0, n1, RIPPLE_CARRY);
+}
 
+unsigned_int operator-(const unsigned_int &n0, const unsigned_int &n1)
+{
+	return subtract(n0, n1, RIPPLE_CARRY);
+}
+
+unsigned_int add(const unsigned_int &n0, const unsigned_int &n1, int style, int threads)
+{
+	int w = fixed_width(n0, n1);
+	size_t m = w > 0 ? w : std::max(n0.bits.size(), n1.bits.size());
+	bitset a = n0, b = n1;
+	a.resize(m);
+	b.resize(m);
+	unsigned_int result = add(a, b, cover(0), style, threads, w == 0);
+	result.fixed = w;
 	return result;
 }
 
-unsigned_int operator-(const unsigned_int &n0, const unsigned_int &n1)
+// n0 + ~n1 + 1, the carry out is 1 when there is no borrow. The result is
+// n0 - n1 modulo 2^(m+1), so the top bit is the borrow.
+unsigned_int subtract(const unsigned_int &n0, const unsigned_int &n1, int style, int threads)
 {
-	unsigned_int result;
-	cover carry = 1, inf;
-	int m = (int)std::min(n0.bits.size(), n1.bits.size());
-	for (int i = 0; i < m; i++)
-	{
-		result.bits.push_back((n0.bits[i]&n1.bits[i]&~carry) | (~n0.bits[i]&~n1.bits[i]&~carry) | (~n0.bits[i]&n1.bits[i]&carry));
-		carry = (n0.bits[i]&~n1.bits[i]) | (n0.bits[i]&carry) | (~n1.bits[i]&carry);
-	}
-	for (int i = m; i < (int)n0.bits.size(); i++)
-	{
-		result.bits.push_back(~n0.bits[i]&~carry);
-		carry = n0.bits[i] | carry;
-	}
-	for (int i = m; i < (int)n1.bits.size(); i++)
+	int w = fixed_width(n0, n1);
+	size_t m = w > 0 ? w : std::max(n0.bits.size(), n1.bits.size());
+	bitset a = n0, b = n1;
+	a.resize(m);
+	b.resize(m);
+	unsigned_int result = add(a, ~b, cover(1), style, threads, w == 0);
+	if (w == 0)
+		result.bits.back() = ~result.bits.back();
+	result.fixed = w;
+	return result;
+}
+
+unsigned_int operator*(const unsigned_int &n0, const unsigned_int &n1)
+{
+	return multiply(n0, n1, DADDA_TREE);
+}
+
+unsigned_int multiply(const unsigned_int &n0, const unsigned_int &n1, int style, int adder, bool minimize, int threads)
+{
+	unsigned_int a, b;
+	truncate(n0, n1, a, b);
+	int w = fixed_width(n0, n1);
+	int width = (int)(a.bits.size() + b.bits.size());
+	if (w > 0)
+		width = std::min(width, w);
+
+	unsigned long x, y;
+	if (a.bits.size() + b.bits.size() <= 64 and a.to_constant(&x) and b.to_constant(&y))
 	{
-		result.bits.push_back((~n1.bits[i]&~carry) | (n1.bits[i]&carry));
-		carry = ~n1.bits[i]&carry;
+		unsigned_int result = from_constant(x*y, width);
+		result.fixed = w;
+		return result;
 	}
-	result.bits.push_back(carry);
 
+	vector<vector<cover> > columns(width);
+	for (int i = 0; i < (int)b.bits.size(); i++)
+		for (int j = 0; j < (int)a.bits.size() and i+j < width; j++)
+			columns[i+j].push_back(a.bits[j] & b.bits[i]);
+
+	unsigned_int result = carry_save(columns, style, adder, minimize, threads);
+	result.fixed = w;
 	return result;
 }
 
-unsigned_int operator*(const unsigned_int &n0, const unsigned_int &n1)
+unsigned_int operator/(const unsigned_int &n0, const unsigned_int &n1)
 {
-	unsigned_int result;
-	for (int i = 0; i < (int)n1.bits.size(); i++)
-		result = result + ((n0&n1.bits[i]) << i);
+	unsigned_int a, b;
+	truncate(n0, n1, a, b);
+	bitset q;
+	divide(a, b, &q, NULL);
+	unsigned_int result = q;
+	result.fixed = fixed_width(n0, n1);
 	return result;
 }
 
-unsigned_int operator/(const unsigned_int &n0, const unsigned_int &n1)
+unsigned_int operator%(const unsigned_int &n0, const unsigned_int &n1)
 {
-	unsigned_int result;
-	result.bits.resize(n0.bits.size(), cover(0));
-	unsigned_int iter = n0;
+	unsigned_int a, b;
+	truncate(n0, n1, a, b);
+	bitset r;
+	divide(a, b, NULL, &r);
+	unsigned_int result = r;
+	result.fixed = fixed_width(n0, n1);
+	return result;
+}
 
-	int s = (int)iter.bits.size()-1;
-	for (int i = s; i >= 0; i--)
+// Give a bitwise result the fixed width w, zero or sign extending it or
+// dropping the bits above w.
+static unsigned_int fixed_result(const bitset &n, int w)
+{
+	unsigned_int result(n);
+	if (w > 0)
 	{
-		unsigned_int divisor = (n1 << i);
-		cover condition = (divisor < iter);
-		result.bits[i] = condition;
-		iter = (condition&(iter-divisor)) | (~condition&iter);
-		iter.espresso();
+		result.resize(w);
+		result.fixed = w;
 	}
-
 	return result;
 }
 
-cover operator<(const unsigned_int &n0, const unsigned_int &n1)
+unsigned_int operator~(const unsigned_int &n)
+{
+	unsigned_int a = n;
+	if (a.fixed > 0)
+		a.resize(a.fixed);
+	const bitset &b = a;
+	return fixed_result(~b, n.fixed);
+}
+
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator&(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a & b, fixed_width(n0, n1));
+}
+
+template unsigned_int operator&<unsigned_int>(const unsigned_int &n0, const unsigned_int &n1);
+
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator|(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a | b, fixed_width(n0, n1));
+}
+
+template unsigned_int operator|<unsigned_int>(const unsigned_int &n0, const unsigned_int &n1);
+
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator^(const T &n0, const T &n1)
+{
+	const bitset &a = n0, &b = n1;
+	return fixed_result(a ^ b, fixed_width(n0, n1));
+}
+
+template unsigned_int operator^<unsigned_int>(const unsigned_int &n0, const unsigned_int &n1);
+
+unsigned_int operator<<(const unsigned_int &n, int s)
+{
+	const bitset &a = n;
+	return fixed_result(a << s, n.fixed);
+}
+
+unsigned_int operator>>(const unsigned_int &n, int s)
 {
-	cover disjunction(0);
+	const bitset &a = n;
+	return fixed_result(a >> s, n.fixed);
+}
+
+cover operator<(const unsigned_int &v0, const unsigned_int &v1)
+{
+	unsigned_int n0, n1;
+	truncate(v0, v1, n0, n1);
+
+	unsigned long a, b;
+	if (n0.to_constant(&a) and n1.to_constant(&b))
+		return cover(a < b);
+
+	cover_builder disjunction;
 	cover conjunction(1);
 
 	// if n1 has more bits than n0, all it takes is one of those bits
@@ -150,10 +293,10 @@ cover operator<(const unsigned_int &n0, const unsigned_int &n1)
 	for (int i = m; i >= 0; i--)
 	{
 		disjunction |= ~n0.bits[i]&n1.bits[i]&conjunction;
-		conjunction &= (n0.bits[i]&n1.bits[i]) | (~n0.bits[i]&~n1.bits[i]);
+		conjunction &= xnor(n0.bits[i], n1.bits[i]);
 	}
 
-	return disjunction;
+	return disjunction.get();
 }
 
 cover operator>(const unsigned_int &n0, const unsigned_int &n1)
@@ -171,7 +314,8 @@ cover operator<=(const unsigned_int &n0, const unsigned_int &n1)
 	return ~(n1 < n0);
 }
 
-boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide)
+template <typename table>
+static boolean::unsigned_int hfactor(boolean::unsigned_int c, int w, table &factors, int offset, const vector<int> &hide)
 {
 	if (c.max_width() >= w and c.depth() > 1) {
 		boolean::cube common = c.supercube();
@@ -182,23 +326,16 @@ boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, map<bool
 			boolean::unsigned_int left_result, right_result;
 			c.partition(c_left, c_right);
 
-			left_result = decompose_hfactor(c_left, w, factors, offset, hide);
-			right_result = decompose_hfactor(c_right, w, factors, offset, hide);
+			left_result = hfactor(c_left, w, factors, offset, hide);
+			right_result = hfactor(c_right, w, factors, offset, hide);
 			return left_result | right_result;
 		}
 		else
 		{
 			c.cofactor(common);
-			int index = -1;
-			map<boolean::cube, int>::iterator loc = factors.find(common);
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(common, index));
-			} else {
-				index = loc->second;
-			}
+			int index = factor_index(factors, common, offset);
 
-			boolean::unsigned_int result = decompose_hfactor(c, w, factors, offset, hide);
+			boolean::unsigned_int result = hfactor(c, w, factors, offset, hide);
 			for (int i = 0; i < (int)result.bits.size(); i++) {
 				result.bits[i] &= boolean::cube(index, 1);
 			}
@@ -209,7 +346,8 @@ boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, map<bool
 	return c;
 }
 
-boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide)
+template <typename table>
+static boolean::unsigned_int xfactor(boolean::unsigned_int c, int w, table &factors, int offset, const vector<int> &hide)
 {
 	if (c.max_width() >= w and c.depth() > 1) {
 		boolean::unsigned_int nc = ~c;
@@ -229,14 +367,14 @@ boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<bool
 
 			if (c_weight <= nc_weight)
 			{
-				left_result = decompose_xfactor(c_left, w, factors, offset, hide);
-				right_result = decompose_xfactor(c_right, w, factors, offset, hide);
+				left_result = xfactor(c_left, w, factors, offset, hide);
+				right_result = xfactor(c_right, w, factors, offset, hide);
 				result = left_result | right_result;
 			}
 			else if (nc_weight < c_weight)
 			{
-				left_result = decompose_xfactor(nc_left, w, factors, offset, hide);
-				right_result = decompose_xfactor(nc_right, w, factors, offset, hide);
+				left_result = xfactor(nc_left, w, factors, offset, hide);
+				right_result = xfactor(nc_right, w, factors, offset, hide);
 				result = left_result | right_result;
 				// TODO We're getting stuck here...
 				result = ~result;
@@ -245,16 +383,9 @@ boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<bool
 		} else if (cw >= ncw) {
 			c.cofactor(common);
 
-			map<boolean::cube, int>::iterator loc = factors.find(common);
-			int index = -1;
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(common, index));
-			} else {
-				index = loc->second;
-			}
+			int index = factor_index(factors, common, offset);
 		
-			boolean::unsigned_int result = decompose_xfactor(c, w, factors, offset, hide);
+			boolean::unsigned_int result = xfactor(c, w, factors, offset, hide);
 			for (int i = 0; i < (int)result.bits.size(); i++) {
 				result.bits[i] &= boolean::cube(index, 1);
 			}
@@ -262,16 +393,9 @@ boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<bool
 		} else if (ncw > cw) {
 			nc.cofactor(ncommon);
 
-			map<boolean::cube, int>::iterator loc = factors.find(ncommon);
-			int index = -1;
-			if (loc == factors.end()) {
-				index = offset + factors.size();
-				factors.insert(pair<boolean::cube, int>(ncommon, index));
-			} else {
-				index = loc->second;
-			}
+			int index = factor_index(factors, ncommon, offset);
 			
-			boolean::unsigned_int result = decompose_xfactor(nc, w, factors, offset, hide);
+			boolean::unsigned_int result = xfactor(nc, w, factors, offset, hide);
 			for (int i = 0; i < (int)result.bits.size(); i++) {
 				result.bits[i] &= boolean::cube(index, 1);
 			}
@@ -282,4 +406,24 @@ boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<bool
 	return c;
 }
 
+boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, factor_table &factors, int offset, vector<int> hide)
+{
+	return hfactor(c, w, factors, offset, hide);
+}
+
+boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, factor_table &factors, int offset, vector<int> hide)
+{
+	return xfactor(c, w, factors, offset, hide);
+}
+
+boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide)
+{
+	return hfactor(c, w, factors, offset, hide);
+}
+
+boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide)
+{
+	return xfactor(c, w, factors, offset, hide);
+}
+
 }
@@ -7,7 +7,12 @@
 
 #pragma once
 
+#include <concepts>
+
 #include <boolean/bitset.h>
+#include <boolean/adder.h>
+#include <boolean/multiplier.h>
+#include <boolean/divider.h>
 
 namespace boolean
 {
@@ -22,23 +27,60 @@ struct unsigned_int : bitset
 	unsigned_int(const unsigned_int &n);
 	~unsigned_int();
 
+	// When nonzero, arithmetic on this value is computed modulo 2^fixed and
+	// the bits above that are never built. The result of an operation is
+	// fixed to the wider of its fixed operands. A value converted from a
+	// plain bitset is never fixed.
+	int fixed;
+
+	unsigned_int &fix(int width);
+
 	unsigned_int &operator+=(const unsigned_int &n);
 	unsigned_int &operator-=(const unsigned_int &n);
 	unsigned_int &operator*=(const unsigned_int &n);
 	unsigned_int &operator/=(const unsigned_int &n);
-	//unsigned_int &operator%=(const unsigned_int &n);
+	unsigned_int &operator%=(const unsigned_int &n);
+	unsigned_int &operator&=(const unsigned_int &n);
+	unsigned_int &operator|=(const unsigned_int &n);
+	unsigned_int &operator^=(const unsigned_int &n);
+	unsigned_int &operator<<=(int s);
+	unsigned_int &operator>>=(int s);
 };
 
 unsigned_int operator+(const unsigned_int &n0, const unsigned_int &n1);
 unsigned_int operator-(const unsigned_int &n0, const unsigned_int &n1);
 unsigned_int operator*(const unsigned_int &n0, const unsigned_int &n1);
 unsigned_int operator/(const unsigned_int &n0, const unsigned_int &n1);
+unsigned_int operator%(const unsigned_int &n0, const unsigned_int &n1);
+
+// The bitwise operators keep the fixed width of their operands, dropping the
+// bits shifted past it. The binary ones only match two unsigned_ints, anything
+// mixed with a plain bitset or cover goes to the bitset operators instead.
+unsigned_int operator~(const unsigned_int &n);
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator&(const T &n0, const T &n1);
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator|(const T &n0, const T &n1);
+template <typename T> requires std::same_as<T, unsigned_int>
+T operator^(const T &n0, const T &n1);
+unsigned_int operator<<(const unsigned_int &n, int s);
+unsigned_int operator>>(const unsigned_int &n, int s);
+
+// operator+ and operator- with a selectable adder, see adder.h
+unsigned_int add(const unsigned_int &n0, const unsigned_int &n1, int style, int threads = 1);
+unsigned_int subtract(const unsigned_int &n0, const unsigned_int &n1, int style, int threads = 1);
+
+// operator* with a selectable partial product reduction, see multiplier.h.
+// The result is exactly n0.bits.size() + n1.bits.size() bits wide.
+unsigned_int multiply(const unsigned_int &n0, const unsigned_int &n1, int style, int adder = RIPPLE_CARRY, bool minimize = false, int threads = 1);
 
 cover operator<(const unsigned_int &n0, const unsigned_int &n1);
 cover operator>(const unsigned_int &n0, const unsigned_int &n1);
 cover operator<=(const unsigned_int &n0, const unsigned_int &n1);
 cover operator>=(const unsigned_int &n0, const unsigned_int &n1);
 
+boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, factor_table &factors, int offset, vector<int> hide);
+boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, factor_table &factors, int offset, vector<int> hide);
 boolean::unsigned_int decompose_hfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide);
 boolean::unsigned_int decompose_xfactor(boolean::unsigned_int c, int w, map<boolean::cube, int> &factors, int offset, vector<int> hide);
 
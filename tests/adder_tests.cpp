@@ -0,0 +1,419 @@
+#include <gtest/gtest.h>
+#include <boolean/adder.h>
+#include <boolean/unsigned_int.h>
+#include <boolean/signed_int.h>
+
+using namespace boolean;
+
+// Evaluate a symbolic bitset under a full assignment of its variables. Bits
+// are read as a two's complement number when is_signed is set.
+static long evaluate(const boolean::bitset &n, const cube &assignment, bool is_signed) {
+	long result = 0;
+	for (int i = 0; i < (int)n.bits.size(); i++) {
+		cover bit = cofactor(n.bits[i], assignment);
+		EXPECT_TRUE(bit.is_null() or bit.is_tautology());
+		if (bit.is_tautology()) {
+			result |= 1l << i;
+		}
+	}
+	if (is_signed and not n.bits.empty() and ((result >> (n.bits.size()-1)) & 1)) {
+		result -= 1l << n.bits.size();
+	}
+	return result;
+}
+
+static cube assign(unsigned long a, unsigned long b, int width) {
+	vector<int> vars;
+	for (int i = 0; i < 2*width; i++) {
+		vars.push_back(i);
+	}
+	return encode_binary(a | (b << width), vars);
+}
+
+// Every adder style computes the same sums
+TEST(AdderTest, UnsignedStyles) {
+	const int w = 3;
+	unsigned_int a(w, 0);
+	unsigned_int b(w, w);
+
+	for (int style = RIPPLE_CARRY; style <= BRENT_KUNG; style++) {
+		unsigned_int sum = add(a, b, style, 2);
+		unsigned_int diff = subtract(a, b, style, 2);
+		EXPECT_EQ(sum.bits.size(), size_t(w+1));
+		EXPECT_EQ(diff.bits.size(), size_t(w+1));
+		for (unsigned long x = 0; x < (1ul<<w); x++) {
+			for (unsigned long y = 0; y < (1ul<<w); y++) {
+				cube asg = assign(x, y, w);
+				EXPECT_EQ(evaluate(sum, asg, false), (long)(x+y)) << "style " << style;
+				EXPECT_EQ(evaluate(diff, asg, false), (long)((x-y) & ((1ul<<(w+1))-1))) << "style " << style;
+			}
+		}
+	}
+}
+
+TEST(AdderTest, SignedStyles) {
+	const int w = 3;
+	signed_int a(w, 0);
+	signed_int b(w, w);
+
+	for (int style = RIPPLE_CARRY; style <= BRENT_KUNG; style++) {
+		signed_int sum = add(a, b, style);
+		signed_int diff = subtract(a, b, style);
+		for (unsigned long x = 0; x < (1ul<<w); x++) {
+			for (unsigned long y = 0; y < (1ul<<w); y++) {
+				long sx = (long)x - (x >= 4 ? 8 : 0);
+				long sy = (long)y - (y >= 4 ? 8 : 0);
+				cube asg = assign(x, y, w);
+				EXPECT_EQ(evaluate(sum, asg, true), sx+sy) << "style " << style;
+				EXPECT_EQ(evaluate(diff, asg, true), sx-sy) << "style " << style;
+			}
+		}
+	}
+}
+
+// Operands of different widths are extended before adding
+TEST(AdderTest, MixedWidths) {
+	unsigned_int a(4, 0);
+	unsigned_int b(2, 4);
+	unsigned_int ripple = add(a, b, RIPPLE_CARRY);
+	unsigned_int prefix = add(a, b, KOGGE_STONE);
+	unsigned_int tree = add(a, b, BRENT_KUNG);
+	ASSERT_EQ(ripple.bits.size(), size_t(5));
+	ASSERT_EQ(prefix.bits.size(), size_t(5));
+	ASSERT_EQ(tree.bits.size(), size_t(5));
+	for (int i = 0; i < 5; i++) {
+		EXPECT_TRUE(ripple.bits[i] == prefix.bits[i]);
+		EXPECT_TRUE(ripple.bits[i] == tree.bits[i]);
+	}
+
+	unsigned_int five(5ul);
+	unsigned_int three(3ul);
+	EXPECT_EQ(evaluate(add(five, three, KOGGE_STONE), cube(), false), 8);
+	EXPECT_EQ(evaluate(add(five, three, BRENT_KUNG), cube(), false), 8);
+	EXPECT_EQ(evaluate(subtract(five, three, BRENT_KUNG), cube(), false), 2);
+}
+
+// Every multiplier style computes the same products
+TEST(MultiplierTest, UnsignedStyles) {
+	const int w = 3;
+	unsigned_int a(w, 0);
+	unsigned_int b(w, w);
+
+	for (int style = SHIFT_ADD; style <= DADDA_TREE; style++) {
+		for (int minimize = 0; minimize < 2; minimize++) {
+			unsigned_int product = multiply(a, b, style, BRENT_KUNG, minimize, 2);
+			EXPECT_EQ(product.bits.size(), size_t(2*w));
+			for (unsigned long x = 0; x < (1ul<<w); x++) {
+				for (unsigned long y = 0; y < (1ul<<w); y++) {
+					EXPECT_EQ(evaluate(product, assign(x, y, w), false), (long)(x*y)) << "style " << style;
+				}
+			}
+		}
+	}
+
+	unsigned_int six(6ul);
+	unsigned_int seven(7ul);
+	EXPECT_EQ(evaluate(multiply(six, seven, WALLACE_TREE), cube(), false), 42);
+	EXPECT_EQ(evaluate(multiply(six, seven, DADDA_TREE), cube(), false), 42);
+}
+
+// Every minimize policy computes the same quotients and remainders
+TEST(DividerTest, Unsigned) {
+	const int w = 3;
+	unsigned_int a(w, 0);
+	unsigned_int b(w, w);
+
+	for (int policy = MINIMIZE_NEVER; policy <= MINIMIZE_EACH_STEP; policy++) {
+		boolean::bitset quotient, remainder;
+		divide(a, b, &quotient, &remainder, KOGGE_STONE, policy);
+		EXPECT_EQ(quotient.bits.size(), size_t(w));
+		EXPECT_EQ(remainder.bits.size(), size_t(w));
+		for (unsigned long x = 0; x < (1ul<<w); x++) {
+			for (unsigned long y = 1; y < (1ul<<w); y++) {
+				cube asg = assign(x, y, w);
+				EXPECT_EQ(evaluate(quotient, asg, false), (long)(x/y)) << "policy " << policy;
+				EXPECT_EQ(evaluate(remainder, asg, false), (long)(x%y)) << "policy " << policy;
+			}
+			// division by zero
+			EXPECT_EQ(evaluate(quotient, assign(x, 0, w), false), (long)((1ul<<w)-1));
+			EXPECT_EQ(evaluate(remainder, assign(x, 0, w), false), (long)x);
+		}
+	}
+
+	unsigned_int q = a / b;
+	unsigned_int r = a % b;
+	for (unsigned long x = 0; x < (1ul<<w); x++) {
+		for (unsigned long y = 1; y < (1ul<<w); y++) {
+			EXPECT_EQ(evaluate(q, assign(x, y, w), false), (long)(x/y));
+			EXPECT_EQ(evaluate(r, assign(x, y, w), false), (long)(x%y));
+		}
+	}
+
+	unsigned_int thirteen(13ul);
+	unsigned_int five(5ul);
+	EXPECT_EQ(evaluate(thirteen / five, cube(), false), 2);
+	EXPECT_EQ(evaluate(thirteen % five, cube(), false), 3);
+}
+
+// A dividend wider than the divisor, including a symbolic division by zero
+TEST(DividerTest, MismatchedWidths) {
+	const int m = 6, n = 2;
+	unsigned_int a(m, 0);
+	unsigned_int b(n, m);
+	vector<int> vars;
+	for (int i = 0; i < m+n; i++) {
+		vars.push_back(i);
+	}
+
+	for (int policy = MINIMIZE_NEVER; policy <= MINIMIZE_EACH_STEP; policy++) {
+		boolean::bitset quotient, remainder;
+		divide(a, b, &quotient, &remainder, RIPPLE_CARRY, policy);
+		EXPECT_EQ(quotient.bits.size(), size_t(m));
+		EXPECT_EQ(remainder.bits.size(), size_t(n));
+		for (unsigned long x = 0; x < (1ul<<m); x++) {
+			for (unsigned long y = 0; y < (1ul<<n); y++) {
+				cube asg = encode_binary(x | (y << m), vars);
+				long q = y == 0 ? (1l<<m)-1 : (long)(x/y);
+				long r = y == 0 ? (long)(x & ((1ul<<n)-1)) : (long)(x%y);
+				EXPECT_EQ(evaluate(quotient, asg, false), q) << x << "/" << y << " policy " << policy;
+				EXPECT_EQ(evaluate(remainder, asg, false), r) << x << "%" << y << " policy " << policy;
+			}
+		}
+	}
+}
+
+// Negation and comparison widen by at most one bit without iterating the
+// sign extension
+TEST(SignedIntArithmetic, NegationAndComparison) {
+	const int w = 3;
+	signed_int a(w, 0);
+	signed_int b(w, w);
+
+	signed_int neg = -a;
+	signed_int sum = a + b;
+	signed_int diff = a - b;
+	cover lt = a < b;
+	cover ge = a >= b;
+	EXPECT_EQ(neg.bits.size(), size_t(w+1));
+	EXPECT_EQ(sum.bits.size(), size_t(w+1));
+	EXPECT_EQ(diff.bits.size(), size_t(w+1));
+	for (unsigned long x = 0; x < (1ul<<w); x++) {
+		for (unsigned long y = 0; y < (1ul<<w); y++) {
+			long sx = (long)x - ((x >> (w-1)) << w);
+			long sy = (long)y - ((y >> (w-1)) << w);
+			cube asg = assign(x, y, w);
+			EXPECT_EQ(evaluate(neg, asg, true), -sx);
+			EXPECT_EQ(evaluate(sum, asg, true), sx+sy);
+			EXPECT_EQ(evaluate(diff, asg, true), sx-sy);
+			EXPECT_EQ(cofactor(lt, asg).is_tautology(), sx < sy);
+			EXPECT_EQ(cofactor(ge, asg).is_tautology(), sx >= sy);
+		}
+	}
+
+	signed_int minus_four(-4l);
+	EXPECT_EQ(evaluate(-minus_four, cube(), true), 4);
+	EXPECT_EQ(evaluate(-signed_int(0l), cube(), true), 0);
+	EXPECT_TRUE((signed_int(-1l) < signed_int(2l)).is_tautology());
+	EXPECT_TRUE((signed_int(3l) < signed_int(-2l)).is_null());
+}
+
+// Booth recoded products for every multiplier style
+TEST(MultiplierTest, SignedStyles) {
+	const int w = 3;
+	signed_int a(w, 0);
+	signed_int b(w, w);
+
+	for (int style = SHIFT_ADD; style <= DADDA_TREE; style++) {
+		signed_int product = multiply(a, b, style, KOGGE_STONE, style == WALLACE_TREE);
+		EXPECT_EQ(product.bits.size(), size_t(2*w));
+		for (unsigned long x = 0; x < (1ul<<w); x++) {
+			for (unsigned long y = 0; y < (1ul<<w); y++) {
+				long sx = (long)x - ((x >> (w-1)) << w);
+				long sy = (long)y - ((y >> (w-1)) << w);
+				EXPECT_EQ(evaluate(product, assign(x, y, w), true), sx*sy) << "style " << style;
+			}
+		}
+	}
+
+	EXPECT_EQ(evaluate(signed_int(-7l) * signed_int(6l), cube(), true), -42);
+	EXPECT_EQ(evaluate(signed_int(-8l) * signed_int(-8l), cube(), true), 64);
+	EXPECT_EQ(evaluate(signed_int(5l) * signed_int(0l), cube(), true), 0);
+}
+
+// Booth recoding at odd and even widths above 4 and with operands of
+// different widths, including the most negative value of each
+TEST(MultiplierTest, BoothWidths) {
+	const int widths[][2] = {{5, 5}, {6, 6}, {5, 3}, {3, 6}, {6, 5}};
+	for (const auto &width : widths) {
+		int m = width[0], n = width[1];
+		signed_int a(m, 0);
+		signed_int b(n, m);
+		vector<int> vars;
+		for (int i = 0; i < m+n; i++) {
+			vars.push_back(i);
+		}
+
+		signed_int product = multiply(a, b, DADDA_TREE);
+		EXPECT_EQ(product.bits.size(), size_t(m+n));
+		for (unsigned long x = 0; x < (1ul<<m); x++) {
+			for (unsigned long y = 0; y < (1ul<<n); y++) {
+				long sx = (long)x - ((x >> (m-1)) << m);
+				long sy = (long)y - ((y >> (n-1)) << n);
+				EXPECT_EQ(evaluate(product, encode_binary(x | (y << m), vars), true), sx*sy) << m << "x" << n;
+			}
+		}
+	}
+
+	// a symbolic operand keeps the product off the constant path
+	const int w = 8;
+	signed_int a(w, 0);
+	vector<int> vars;
+	for (int i = 0; i < w; i++) {
+		vars.push_back(i);
+	}
+	signed_int by_min = multiply(a, signed_int(-128l), WALLACE_TREE);
+	signed_int min_first = multiply(signed_int(-128l), a, SHIFT_ADD);
+	for (unsigned long x : {0x80ul, 0x81ul, 0x7Ful, 0xFFul, 0x00ul, 0x01ul}) {
+		long sx = (long)x - ((x >> (w-1)) << w);
+		EXPECT_EQ(evaluate(by_min, encode_binary(x, vars), true), sx*-128) << x;
+		EXPECT_EQ(evaluate(min_first, encode_binary(x, vars), true), sx*-128) << x;
+	}
+}
+
+// Concrete operands fold to the same value and width as the symbolic path
+TEST(ConstantFolding, Concrete) {
+	unsigned_int a(13ul), b(29ul);
+	unsigned_int sum = a + b;
+	EXPECT_EQ(sum.bits.size(), size_t(6));
+	EXPECT_TRUE(sum.is_constant());
+	EXPECT_EQ(evaluate(sum, cube(), false), 42);
+
+	unsigned_int diff = a - b;
+	EXPECT_EQ(diff.bits.size(), size_t(6));
+	EXPECT_EQ(evaluate(diff, cube(), false), (13-29) & 63);
+
+	unsigned_int product = multiply(a, b, DADDA_TREE);
+	EXPECT_EQ(product.bits.size(), size_t(9));
+	EXPECT_EQ(evaluate(product, cube(), false), 13*29);
+	EXPECT_EQ(evaluate(a*b, cube(), false), 13*29);
+
+	EXPECT_EQ(evaluate(b / a, cube(), false), 2);
+	EXPECT_EQ(evaluate(b % a, cube(), false), 3);
+	EXPECT_EQ((b / a).bits.size(), size_t(5));
+	EXPECT_EQ((b % a).bits.size(), size_t(4));
+	EXPECT_TRUE((a < b).is_tautology());
+	EXPECT_TRUE((b < a).is_null());
+
+	EXPECT_EQ(evaluate(signed_int(-3l) * signed_int(-5l), cube(), true), 15);
+	EXPECT_EQ(evaluate(signed_int(-3l) + signed_int(5l), cube(), true), 2);
+}
+
+// A constant operand short-circuits the gates it feeds
+TEST(ConstantFolding, Mixed) {
+	const int w = 3;
+	unsigned_int a(w, 0);
+	unsigned_int one(1ul), five(5ul);
+
+	unsigned_int inc = a + one;
+	unsigned_int scaled = multiply(a, five, WALLACE_TREE);
+	unsigned_int quotient = a / unsigned_int(3ul);
+	for (unsigned long x = 0; x < (1ul<<w); x++) {
+		cube asg = assign(x, 0, w);
+		EXPECT_EQ(evaluate(inc, asg, false), (long)(x+1));
+		EXPECT_EQ(evaluate(scaled, asg, false), (long)(x*5));
+		EXPECT_EQ(evaluate(quotient, asg, false), (long)(x/3));
+	}
+
+	EXPECT_TRUE(full_carry(cover(0), cover(0, 1), cover(1, 1)) == (cover(0, 1) & cover(1, 1)));
+	EXPECT_TRUE(full_sum(cover(0, 1), cover(1), cover(1, 1)) == ((cover(0, 1) & cover(1, 1)) | (cover(0, 0) & cover(1, 0))));
+}
+
+// Fixed width values wrap modulo 2^w instead of growing
+TEST(FixedWidth, Unsigned) {
+	const int w = 3;
+	unsigned_int a(w, 0), b(w, w);
+	a.fix(w);
+
+	unsigned_int sum = a + b;
+	unsigned_int diff = a - b;
+	unsigned_int product = a * b;
+	unsigned_int tree = multiply(a, b, WALLACE_TREE, KOGGE_STONE);
+	unsigned_int chained = (a + b) * b + a;
+	unsigned_int inverted = ~a;
+	unsigned_int shifted = a << 2;
+	unsigned_int mixed = ((a ^ b) >> 1) | (a & b);
+	EXPECT_EQ(sum.bits.size(), size_t(w));
+	EXPECT_EQ(inverted.bits.size(), size_t(w));
+	EXPECT_EQ(inverted.fixed, w);
+	EXPECT_EQ(shifted.bits.size(), size_t(w));
+	EXPECT_EQ(shifted.fixed, w);
+	EXPECT_EQ(mixed.fixed, w);
+	EXPECT_EQ(diff.bits.size(), size_t(w));
+	EXPECT_EQ(product.bits.size(), size_t(w));
+	EXPECT_EQ(chained.bits.size(), size_t(w));
+	EXPECT_EQ(chained.fixed, w);
+	for (unsigned long x = 0; x < (1ul<<w); x++) {
+		for (unsigned long y = 0; y < (1ul<<w); y++) {
+			cube asg = assign(x, y, w);
+			EXPECT_EQ(evaluate(sum, asg, false), (long)((x+y) & 7));
+			EXPECT_EQ(evaluate(diff, asg, false), (long)((x-y) & 7));
+			EXPECT_EQ(evaluate(product, asg, false), (long)((x*y) & 7));
+			EXPECT_EQ(evaluate(tree, asg, false), (long)((x*y) & 7));
+			EXPECT_EQ(evaluate(chained, asg, false), (long)(((x+y)*y + x) & 7));
+			EXPECT_EQ(evaluate(inverted, asg, false), (long)(~x & 7));
+			EXPECT_EQ(evaluate(shifted, asg, false), (long)((x << 2) & 7));
+			EXPECT_EQ(evaluate(mixed, asg, false), (long)((((x^y) >> 1) | (x&y)) & 7));
+		}
+	}
+
+	unsigned_int big(200ul);
+	big.fix(4);
+	EXPECT_EQ(big.bits.size(), size_t(4));
+	EXPECT_EQ(evaluate(big + unsigned_int(9ul), cube(), false), (200+9) & 15);
+	EXPECT_EQ(evaluate(big * unsigned_int(3ul), cube(), false), (200*3) & 15);
+	EXPECT_EQ(evaluate(~big, cube(), false), ~200 & 15);
+	EXPECT_EQ(evaluate(big << 3, cube(), false), (200 << 3) & 15);
+
+	// compound assignment keeps the width too
+	unsigned_int c = big;
+	c <<= 2;
+	c |= unsigned_int(1ul);
+	EXPECT_EQ(c.fixed, 4);
+	EXPECT_EQ(evaluate(c, cube(), false), ((200 << 2) | 1) & 15);
+}
+
+TEST(FixedWidth, Signed) {
+	const int w = 3;
+	signed_int a(w, 0), b(w, w);
+	a.fix(w);
+	b.fix(w);
+
+	signed_int neg = -a;
+	signed_int sum = a + b;
+	signed_int product = a * b;
+	cover lt = a < b;
+	signed_int inverted = ~a;
+	signed_int shifted = a << 1;
+	signed_int halved = a >> 1;
+	EXPECT_EQ(neg.bits.size(), size_t(w));
+	EXPECT_EQ(inverted.bits.size(), size_t(w));
+	EXPECT_EQ(shifted.bits.size(), size_t(w));
+	EXPECT_EQ(halved.bits.size(), size_t(w));
+	EXPECT_EQ(sum.bits.size(), size_t(w));
+	EXPECT_EQ(product.bits.size(), size_t(w));
+	for (unsigned long x = 0; x < (1ul<<w); x++) {
+		for (unsigned long y = 0; y < (1ul<<w); y++) {
+			long sx = (long)x - ((x >> (w-1)) << w);
+			long sy = (long)y - ((y >> (w-1)) << w);
+			cube asg = assign(x, y, w);
+			auto wrap = [](long v) { v &= 7; return v >= 4 ? v - 8 : v; };
+			EXPECT_EQ(evaluate(neg, asg, true), wrap(-sx));
+			EXPECT_EQ(evaluate(sum, asg, true), wrap(sx+sy));
+			EXPECT_EQ(evaluate(product, asg, true), wrap(sx*sy));
+			EXPECT_EQ(cofactor(lt, asg).is_tautology(), sx < sy);
+			EXPECT_EQ(evaluate(inverted, asg, true), ~sx);
+			EXPECT_EQ(evaluate(shifted, asg, true), wrap(sx*2));
+			EXPECT_EQ(evaluate(halved, asg, true), sx >> 1);
+		}
+	}
+}
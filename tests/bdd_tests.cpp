@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <boolean/bdd.h>
+
+using namespace boolean;
+
+// The same function written as two different covers must reach the same edge
+TEST(BddTest, Canonical) {
+	bdd m;
+	cover a = (cover(0, 1) & cover(1, 1)) | (cover(0, 0) & cover(2, 1)) | (cover(1, 1) & cover(2, 1));
+	cover b = (cover(0, 1) & cover(1, 1)) | (cover(0, 0) & cover(2, 1));
+	EXPECT_EQ(m.build(a), m.build(b));
+	EXPECT_NE(m.build(a), m.build(cover(0, 1) & cover(1, 1)));
+
+	// negation is a complemented edge to the same node
+	unsigned int f = m.build(a);
+	int nodes = m.size();
+	unsigned int g = m.apply_not(f);
+	EXPECT_EQ(m.size(), nodes);
+	EXPECT_EQ(m.build(~a), g);
+	EXPECT_EQ(g>>1, f>>1);
+
+	EXPECT_EQ(m.build(cover(1)), bdd::one);
+	EXPECT_EQ(m.build(cover(0)), bdd::zero);
+	EXPECT_EQ(m.build(cover(3, 1) | cover(3, 0)), bdd::one);
+	EXPECT_EQ(m.apply_and(m.var(3), m.var(3, 0)), bdd::zero);
+}
+
+TEST(BddTest, RoundTrip) {
+	bdd m;
+	cover c = (cover(3, 1) & cover(40, 0)) | (cover(17, 1) & cover(65, 1)) | (cover(40, 1) & cover(100, 0) & cover(3, 0)) | cover(255, 1);
+	unsigned int f = m.build(c);
+	cover back = m.extract(f);
+	EXPECT_TRUE(back == c);
+	EXPECT_EQ(m.build(back), f);
+	EXPECT_TRUE(m.extract(m.apply_not(f)) == ~c);
+}
+
+TEST(BddTest, Operations) {
+	bdd m;
+	cover a = (cover(0, 1) & cover(2, 0)) | cover(3, 1);
+	cover b = (cover(1, 1) & cover(2, 1)) | (cover(0, 0) & cover(3, 0));
+	unsigned int f = m.build(a);
+	unsigned int g = m.build(b);
+
+	EXPECT_EQ(m.apply_and(f, g), m.build(a & b));
+	EXPECT_EQ(m.apply_or(f, g), m.build(a | b));
+	EXPECT_EQ(m.apply_xor(f, g), m.build((a & ~b) | (~a & b)));
+	EXPECT_EQ(m.apply_xor(m.apply_not(f), g), m.apply_not(m.apply_xor(f, g)));
+	EXPECT_EQ(m.ite(m.var(1), f, g), m.build((cover(1, 1) & a) | (cover(1, 0) & b)));
+
+	for (int v = 0; v < 4; v++) {
+		for (int val = 0; val < 2; val++) {
+			EXPECT_EQ(m.cofactor(f, v, val), m.build(cofactor(a, v, val))) << "variable " << v << " = " << val;
+		}
+	}
+}
+
+TEST(BddTest, CoverQueries) {
+	bdd m;
+
+	// a chain over 24 variables, too wide for a truth table
+	cover c;
+	for (int i = 0; i < 24; i++) {
+		c |= cover(i, 1) & cover((i+1)%24, 0);
+	}
+
+	cover all = c;
+	for (int i = 0; i < 24; i++) {
+		all |= cover(i, 1);
+	}
+
+	EXPECT_FALSE(m.is_tautology(c));
+	EXPECT_FALSE(m.is_tautology(all));
+	EXPECT_TRUE(m.is_tautology(c | ~c));
+	EXPECT_TRUE(m.is_subset(c, all));
+	EXPECT_FALSE(m.is_subset(all, c));
+	EXPECT_TRUE(m.equal(c, c | (cover(0, 1) & cover(1, 0) & cover(5, 1))));
+	EXPECT_FALSE(m.equal(c, all));
+	EXPECT_TRUE(m.are_mutex(c, ~c));
+	EXPECT_FALSE(m.are_mutex(c, all));
+
+	// repeating a query reuses the converted diagrams
+	int nodes = m.size();
+	EXPECT_TRUE(m.is_subset(c, all));
+	EXPECT_EQ(m.size(), nodes);
+
+	m.clear();
+	EXPECT_EQ(m.size(), 1);
+	EXPECT_TRUE(m.is_subset(c, all));
+}
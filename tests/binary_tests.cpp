@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <boolean/binary.h>
+
+#include <cstdio>
+#include <unistd.h>
+
+using namespace boolean;
+
+static std::string temp(const char *name)
+{
+	return "/tmp/boolean_binary_" + std::to_string(getpid()) + "_" + name + ".bin";
+}
+
+TEST(BinaryTest, RoundTrip) {
+	std::string path = temp("round");
+
+	cube c = cube(0, 1) & cube(17, 0) & cube(40, 1);
+	ASSERT_TRUE(write_binary(path.c_str(), c));
+	binary_file file;
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_EQ(file.header().kind, (uint32_t)BINARY_CUBE);
+	EXPECT_TRUE(file.verify());
+	EXPECT_TRUE(file.to_cube() == c);
+
+	cover f = (cover(0, 1) & cover(20, 0)) | (cover(3, 0) & cover(35, 1)) | cover(1, 1);
+	ASSERT_TRUE(write_binary(path.c_str(), f));
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_EQ(file.header().kind, (uint32_t)BINARY_COVER);
+	EXPECT_EQ(file.header().cubes, 3u);
+	EXPECT_EQ(file.header().stride, 3u);
+	EXPECT_TRUE(file.verify());
+	EXPECT_TRUE(file.to_cover() == f);
+
+	bitset b;
+	b.bits.push_back(f);
+	b.bits.push_back(cover());
+	b.bits.push_back(cover(18, 1) | cover(2, 0));
+	ASSERT_TRUE(write_binary(path.c_str(), b));
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_EQ(file.header().kind, (uint32_t)BINARY_BITSET);
+	EXPECT_TRUE(file.verify());
+	bitset r = file.to_bitset();
+	ASSERT_EQ(r.bits.size(), 3u);
+	for (int i = 0; i < 3; i++)
+		EXPECT_TRUE(r.bits[i] == b.bits[i]);
+
+	file.close();
+	unlink(path.c_str());
+}
+
+TEST(BinaryTest, Views) {
+	std::string path = temp("views");
+
+	cover f = (cover(0, 1) & cover(20, 0)) | cover(5, 0);
+	ASSERT_TRUE(write_binary(path.c_str(), f));
+	binary_file file;
+	ASSERT_TRUE(file.open(path.c_str()));
+
+	// the views point into the mapping rather than at copies
+	cover_view v = file.bit(0);
+	ASSERT_EQ(v.size(), 2);
+	EXPECT_GE((const char*)v[0].values, file.data);
+	EXPECT_LT((const char*)v[1].values, file.data + file.length);
+
+	EXPECT_EQ(v[0].get(0), 1);
+	EXPECT_EQ(v[0].get(20), 0);
+	EXPECT_EQ(v[0].get(5), 2);
+	EXPECT_EQ(v[0].get(100), 2);
+	EXPECT_EQ(v[1].get(5), 0);
+	EXPECT_EQ(v[1].get(20), 2);
+	EXPECT_FALSE(v[0].is_null());
+	EXPECT_TRUE(v[0].to_cube() == f[0]);
+
+	file.close();
+	unlink(path.c_str());
+}
+
+TEST(BinaryTest, Corrupt) {
+	std::string path = temp("corrupt");
+
+	cover f = (cover(0, 1) & cover(20, 0)) | cover(5, 0);
+	ASSERT_TRUE(write_binary(path.c_str(), f));
+
+	// flip a bit in the last word of the last cube
+	FILE *fptr = fopen(path.c_str(), "r+b");
+	ASSERT_TRUE(fptr != NULL);
+	fseek(fptr, -1, SEEK_END);
+	int c = fgetc(fptr);
+	fseek(fptr, -1, SEEK_END);
+	fputc(c ^ 1, fptr);
+	fclose(fptr);
+
+	binary_file file;
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_FALSE(file.verify());
+	file.close();
+
+	// a bad magic number is rejected on open
+	fptr = fopen(path.c_str(), "r+b");
+	ASSERT_TRUE(fptr != NULL);
+	fputc('X', fptr);
+	fclose(fptr);
+	EXPECT_FALSE(file.open(path.c_str()));
+
+	// and so is a truncated file
+	ASSERT_TRUE(write_binary(path.c_str(), f));
+	ASSERT_EQ(truncate(path.c_str(), 50), 0);
+	EXPECT_FALSE(file.open(path.c_str()));
+	EXPECT_FALSE(file.is_open());
+
+	unlink(path.c_str());
+}
+
+static void patch(const std::string &path, long offset, const void *data, size_t size)
+{
+	FILE *fptr = fopen(path.c_str(), "r+b");
+	ASSERT_TRUE(fptr != NULL);
+	fseek(fptr, offset, SEEK_SET);
+	fwrite(data, size, 1, fptr);
+	fclose(fptr);
+}
+
+TEST(BinaryTest, BadHeader) {
+	std::string path = temp("header");
+
+	cover f = (cover(0, 1) & cover(20, 0)) | cover(5, 0);
+	ASSERT_TRUE(write_binary(path.c_str(), f));
+	binary_file file;
+	ASSERT_TRUE(file.open(path.c_str()));
+	binary_header h = file.header();
+	file.close();
+
+	// a cover with other than one bit
+	binary_header bad = h;
+	bad.kind = BINARY_COVER;
+	bad.bits = 0;
+	patch(path, 0, &bad, sizeof(bad));
+	EXPECT_FALSE(file.open(path.c_str()));
+
+	// a cube count that only matches the length once it overflows
+	ASSERT_EQ(h.stride, 2u);
+	bad = h;
+	bad.cubes = h.cubes + ((uint64_t)1 << 61);
+	patch(path, 0, &bad, sizeof(bad));
+	patch(path, sizeof(h) + sizeof(uint64_t), &bad.cubes, sizeof(bad.cubes));
+	EXPECT_FALSE(file.open(path.c_str()));
+
+	patch(path, 0, &h, sizeof(h));
+	patch(path, sizeof(h) + sizeof(uint64_t), &h.cubes, sizeof(h.cubes));
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_TRUE(file.verify());
+	file.close();
+
+	// an empty bitset has no bit to read a cube or cover from
+	ASSERT_TRUE(write_binary(path.c_str(), bitset()));
+	ASSERT_TRUE(file.open(path.c_str()));
+	EXPECT_EQ(file.bits(), 0);
+	EXPECT_EQ(file.bit(0).size(), 0);
+	EXPECT_EQ(file.bit(-1).size(), 0);
+	EXPECT_TRUE(file.to_cover().cubes.empty());
+	EXPECT_TRUE(file.to_cube() == cube());
+	file.close();
+
+	EXPECT_EQ(file.bit(0).size(), 0);
+	unlink(path.c_str());
+}
+
+TEST(BinaryTest, Memory) {
+	std::string path = temp("memory");
+
+	bitset b;
+	b.bits.push_back((cover(0, 1) & cover(20, 0)) | cover(5, 0));
+	b.bits.push_back(cover());
+	b.bits.push_back(cover(40, 1));
+
+	// the image in memory is byte for byte the file
+	std::string image;
+	format_binary(b.bits, image);
+	ASSERT_TRUE(write_binary(path.c_str(), b));
+	FILE *fptr = fopen(path.c_str(), "rb");
+	ASSERT_TRUE(fptr != NULL);
+	std::string written(image.size()+1, '\0');
+	EXPECT_EQ(fread(&written[0], 1, written.size(), fptr), image.size());
+	fclose(fptr);
+	written.resize(image.size());
+	EXPECT_TRUE(written == image);
+
+	vector<cover> r;
+	ASSERT_TRUE(parse_binary(image.data(), image.size(), &r));
+	ASSERT_EQ(r.size(), 3u);
+	for (int i = 0; i < 3; i++)
+		EXPECT_TRUE(r[i] == b.bits[i]);
+
+	// truncated or flipped images are refused
+	EXPECT_FALSE(parse_binary(image.data(), image.size()-4, &r));
+	image[image.size()-1] ^= 1;
+	EXPECT_FALSE(parse_binary(image.data(), image.size(), &r));
+	EXPECT_FALSE(parse_binary(image.data(), 8, &r));
+
+	unlink(path.c_str());
+}
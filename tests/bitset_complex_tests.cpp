@@ -291,3 +291,38 @@ TEST(BitsetComplexTest, DecompositionFunctions) {
 
 	// Don't assert on xfactors - they may not be found in this simple case
 } 
+
+// Parallel decomposition must produce exactly the same factors and result as
+// the sequential one.
+TEST(BitsetComplexTest, ParallelDecomposition) {
+	boolean::bitset dut;
+	for (int i = 0; i < 4; i++) {
+		cover bit;
+		for (int j = 0; j < 6; j++) {
+			cube c;
+			c.set(j, 1);
+			c.set((j+i+1)%8, (i+j)%2);
+			c.set(8+i, 1);
+			bit.push_back(c);
+		}
+		dut.bits.push_back(bit);
+	}
+
+	std::map<boolean::cube, int> seq_factors, par_factors;
+	boolean::bitset seq = dut.decompose_hfactor(seq_factors, 2, 16);
+	boolean::bitset par = dut.decompose_hfactor(par_factors, 2, 16, vector<int>(), 4);
+	EXPECT_EQ(seq_factors, par_factors);
+	ASSERT_EQ(seq.bits.size(), par.bits.size());
+	for (int i = 0; i < (int)seq.bits.size(); i++) {
+		EXPECT_EQ(seq.bits[i].cubes, par.bits[i].cubes);
+	}
+
+	std::map<boolean::cube, int> seq_xfactors, par_xfactors;
+	boolean::bitset xseq = dut.decompose_xfactor(seq_xfactors, 2, 16);
+	boolean::bitset xpar = dut.decompose_xfactor(par_xfactors, 2, 16, vector<int>(), 4);
+	EXPECT_EQ(seq_xfactors, par_xfactors);
+	ASSERT_EQ(xseq.bits.size(), xpar.bits.size());
+	for (int i = 0; i < (int)xseq.bits.size(); i++) {
+		EXPECT_EQ(xseq.bits[i].cubes, xpar.bits[i].cubes);
+	}
+}
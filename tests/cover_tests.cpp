@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <boolean/cover.h>
 #include <boolean/cube.h>
+#include <boolean/task.h>
 
 using namespace boolean;
 
@@ -198,4 +199,283 @@ TEST(CoverTest, TautologyContradiction) {
     
     EXPECT_FALSE(normal.is_null());
     EXPECT_FALSE(normal.is_tautology());
-} 
\ No newline at end of file
+} 
+
+// The union builder gives the same function as a chain of operator|=
+TEST(CoverTest, Builder) {
+    vector<int> vars;
+    for (int i = 0; i < 8; i++) {
+        vars.push_back(i);
+    }
+
+    cover eager;
+    cover_builder deferred;
+    for (unsigned long m = 0; m < 256; m++) {
+        // x0&x1 | x2&~x5 | x7
+        if (((m & 3) == 3) or ((m & 4) and not (m & 32)) or (m & 128)) {
+            eager |= encode_binary(m, vars);
+            deferred |= encode_binary(m, vars);
+        }
+    }
+
+    cover &result = deferred.get();
+    for (unsigned long m = 0; m < 256; m++) {
+        cube asg = encode_binary(m, vars);
+        EXPECT_EQ(cofactor(result, asg).is_tautology(), cofactor(eager, asg).is_tautology());
+    }
+
+    // Nothing is left to merge
+    for (int i = 0; i < result.size(); i++) {
+        for (int j = i+1; j < result.size(); j++) {
+            EXPECT_FALSE(mergible(result[i], result[j]));
+        }
+    }
+    EXPECT_TRUE(result == eager);
+    EXPECT_LE(result.size(), eager.size());
+
+    // Every minterm gives the tautology
+    cover_builder all;
+    for (unsigned long m = 0; m < 256; m++) {
+        all |= encode_binary(m, vars);
+    }
+    EXPECT_TRUE(all.get().is_tautology());
+    EXPECT_EQ(all.get().size(), 1);
+}
+
+// XOR by Shannon expansion matches the sum of products definition
+TEST(CoverTest, Xor) {
+    cover a = (cover(0, 1) & cover(1, 1)) | (cover(2, 0) & cover(3, 1)) | cover(4, 1);
+    cover b = (cover(1, 0) & cover(2, 1)) | (cover(3, 0) & cover(4, 1)) | (cover(0, 0) & cover(5, 1));
+
+    cover expected = (a & ~b) | (~a & b);
+    cover x = a ^ b;
+    cover xn = xnor(a, b);
+
+    vector<int> vars;
+    for (int i = 0; i < 6; i++) {
+        vars.push_back(i);
+    }
+    for (unsigned long m = 0; m < 64; m++) {
+        cube asg = encode_binary(m, vars);
+        bool e = cofactor(expected, asg).is_tautology();
+        EXPECT_EQ(cofactor(x, asg).is_tautology(), e);
+        EXPECT_EQ(cofactor(xn, asg).is_tautology(), not e);
+    }
+
+    EXPECT_TRUE((a ^ a).is_null());
+    EXPECT_TRUE(xnor(a, a).is_tautology());
+    EXPECT_TRUE((a ^ cover(0)) == a);
+    EXPECT_TRUE((a ^ 1) == ~a);
+    // Disjoint covers are just their union
+    EXPECT_TRUE((cover(0, 1) ^ cover(0, 0)).is_tautology());
+}
+
+// Large products are minimized each time they double, and nothing the
+// intermediate minimizations can't merge is lost
+TEST(CoverTest, AndLargeProduct) {
+    cover a, b, c;
+    for (int i = 0; i < 24; i++) {
+        a.push_back(cube(i, 1));
+        b.push_back(cube(24+i, 1));
+    }
+    for (int i = 0; i < 16; i++) {
+        c.push_back(cube(i, 1));
+    }
+
+    // 576 products that don't merge, crossing the limit several times
+    cover p = a & b;
+    cover expected;
+    for (int i = 0; i < 24; i++) {
+        for (int j = 0; j < 24; j++) {
+            expected.push_back(cube(i, 1) & cube(24+j, 1));
+        }
+    }
+    ASSERT_EQ(p.size(), expected.size());
+    sort(p.begin(), p.end());
+    sort(expected.begin(), expected.end());
+    EXPECT_EQ(p.cubes, expected.cubes);
+
+    // 256 products that absorb each other down to c
+    cover q = c & c;
+    EXPECT_EQ(q.size(), c.size());
+    EXPECT_TRUE(q == c);
+}
+
+// Espresso without an off-set only checks containment in F+D
+TEST(CoverTest, EspressoNoOffset) {
+    cover F = (cover(0, 1) & cover(1, 1)) | (cover(0, 1) & cover(1, 0)) | (cover(0, 0) & cover(1, 1));
+    cover G = F;
+    espresso(G, cover());
+    EXPECT_EQ(G.size(), 2);
+    EXPECT_TRUE(G == F);
+
+    // the don't care lets x & y grow to x
+    cover H = cover(0, 1) & cover(1, 1);
+    espresso(H, cover(0, 1) & cover(1, 0));
+    ASSERT_EQ(H.size(), 1);
+    EXPECT_EQ(H[0].width(), 1);
+    EXPECT_EQ(H[0].get(0), 1);
+
+    // wide covers take this path from cover::espresso()
+    cover W;
+    for (int i = 0; i < 20; i++) {
+        W |= cover(2*i, 1) & cover(2*i+1, 1);
+        W |= cover(2*i, 1) & cover(2*i+1, 0) & cover((2*i+2)%40, 1);
+        W |= cover(2*i, 1) & cover(2*i+1, 0) & cover((2*i+2)%40, 0);
+    }
+    cover E = W;
+    E.espresso();
+    EXPECT_EQ(E.size(), 20);
+    for (int i = 0; i < E.size(); i++) {
+        EXPECT_EQ(E[i].width(), 1);
+    }
+    EXPECT_TRUE(E == W);
+}
+
+// Cubes covered by the don't cares are removed, and the rest shrink around them
+TEST(CoverTest, EspressoDontCare) {
+    cover bc = cover(1, 1) & cover(2, 1);
+    cover F = cover(0, 1) | bc;
+    cover R = ~(F | bc);
+    espresso(F, bc, R);
+    ASSERT_EQ(F.size(), 1);
+    EXPECT_TRUE(F == cover(0, 1));
+
+    // without the don't cares b & c has to stay
+    cover G = cover(0, 1) | bc;
+    espresso(G, cover(), ~G);
+    EXPECT_EQ(G.size(), 2);
+
+    cover H = cover(0, 1) & cover(1, 1);
+    reduce(H, cover(0, 1) & cover(1, 1) & cover(2, 1));
+    EXPECT_TRUE(H == (cover(0, 1) & cover(1, 1) & cover(2, 0)));
+
+    cover I = cover(0, 1) | bc;
+    irredundant(I, bc);
+    EXPECT_TRUE(I == cover(0, 1));
+}
+
+TEST(CoverTest, EspressoEffort) {
+    // every minterm of a 6 variable function with a few holes
+    vector<int> vars = {0, 1, 2, 3, 4, 5};
+    cover F;
+    for (unsigned long m = 0; m < 64; m++) {
+        if ((m*37 + 11) % 7 < 4) {
+            F.push_back(encode_binary(m, vars));
+        }
+    }
+    cover R = ~F;
+
+    cover fast = F, normal = F, strong = F, limited = F, timed = F;
+    espresso(fast, cover(), R, espresso_options(EFFORT_FAST));
+    espresso(normal, cover(), R, espresso_options(EFFORT_NORMAL));
+    espresso(strong, cover(), R, espresso_options(EFFORT_STRONG));
+    espresso(limited, cover(), R, espresso_options(EFFORT_STRONG, 0));
+    espresso(timed, cover(), R, espresso_options(EFFORT_NORMAL, -1, 0));
+
+    EXPECT_TRUE(fast == F);
+    EXPECT_TRUE(normal == F);
+    EXPECT_TRUE(strong == F);
+    EXPECT_TRUE(limited == F);
+    EXPECT_TRUE(timed == F);
+    EXPECT_LE(normal.area(), fast.area());
+    EXPECT_LE(strong.area(), fast.area());
+    EXPECT_LT(fast.size(), F.size());
+
+    // the no off-set form takes the same options
+    cover wide = F;
+    espresso(wide, cover(), espresso_options(EFFORT_STRONG, -1, 1000000));
+    EXPECT_TRUE(wide == F);
+    EXPECT_LT(wide.size(), F.size());
+}
+
+// The budget is also seen inside the first expand and irredundant, so a
+// spent budget or a cancelled task gives back F as it was
+TEST(CoverTest, EspressoBudgetFirstPass) {
+    cover F;
+    for (int i = 0; i < 120; i++) {
+        F.push_back(cube(i, 1) & cube((i+1)%120, 0) & cube((i+7)%120, 1) & cube((i+30)%120, 0));
+    }
+
+    for (int effort = EFFORT_FAST; effort <= EFFORT_STRONG; effort++) {
+        cover spent = F;
+        espresso(spent, cover(), espresso_options(effort, -1, 0));
+        EXPECT_EQ(spent.cubes, F.cubes) << effort;
+    }
+
+    task t;
+    t.cancel();
+    cover cancelled = F;
+    {
+        task_scope scope(&t);
+        espresso(cancelled, cover(), espresso_options(EFFORT_STRONG, -1, 60000000));
+    }
+    EXPECT_EQ(cancelled.cubes, F.cubes);
+}
+
+// free is a mask of the parts that may be raised, not a cube, so raising
+// them has to work even though most of its literals look null
+TEST(CoverTest, ExpandFreeParts) {
+    cover F;
+    F.push_back(cube(0, 1) & cube(1, 1));
+    F.push_back(cube(0, 1) & cube(1, 0));
+    ASSERT_EQ(F.size(), 2);
+    cover R = cover(0, 0);
+
+    // only the 0 part of x1 is free
+    cube free;
+    free.values.push_back(0x4);
+    ASSERT_TRUE(free.is_null());
+
+    EXPECT_TRUE(feasible(F, R, 0, free) == cube(0, 1));
+
+    cover G = F;
+    EXPECT_TRUE(guided(G, 0, free));
+    EXPECT_TRUE(G[0] == cube(0, 1));
+
+    // with nothing free, there is nothing to raise
+    cube none;
+    none.values.push_back(0);
+    EXPECT_EQ(feasible(F, R, 0, none).size(), 0);
+    G = F;
+    EXPECT_FALSE(guided(G, 0, none));
+}
+
+// Re-minimizing after a small edit only touches the cubes near it
+TEST(CoverTest, Reminimize) {
+    // x0 & x1 | x2 & x3 | x4 & x5 | x6 & x7
+    cover F;
+    for (int i = 0; i < 4; i++) {
+        F |= cover(2*i, 1) & cover(2*i+1, 1);
+    }
+    F.espresso();
+    ASSERT_EQ(F.size(), 4);
+
+    // adding x0 & ~x1 turns x0 & x1 into x0
+    cover G = F;
+    cover added = cover(0, 1) & cover(1, 0);
+    reminimize(G, added, cover());
+    EXPECT_TRUE(G == (F | added));
+    EXPECT_EQ(G.size(), 4);
+    EXPECT_EQ(G.area(), F.area()-1);
+    for (int i = 1; i < 4; i++) {
+        cube c(2*i, 1);
+        c.set(2*i+1, 1);
+        EXPECT_NE(find(G.begin(), G.end(), c), G.end());
+    }
+
+    // taking x0 & x1 & x2 back out cuts the x0 cube
+    cover H = G;
+    cover removed = cover(0, 1) & cover(1, 1) & cover(2, 1);
+    reminimize(H, cover(), removed);
+    EXPECT_TRUE(H == (G & ~removed));
+
+    // both at once, with a don't care that lets the added cube grow
+    cover I = F;
+    cover cut = cover(2, 1) & cover(3, 1) & cover(4, 1) & cover(8, 0);
+    reminimize(I, cover(8, 1) & cover(9, 1), cut, cover(8, 1) & cover(9, 0));
+    cover expected = (F | (cover(8, 1) & cover(9, 1))) & ~cut;
+    EXPECT_TRUE(I.is_subset_of(expected | (cover(8, 1) & cover(9, 0))));
+    EXPECT_TRUE(expected.is_subset_of(I));
+    EXPECT_NE(find(I.begin(), I.end(), cube(8, 1)), I.end());
+}
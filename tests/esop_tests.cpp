@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <boolean/esop.h>
+
+using namespace boolean;
+
+static vector<int> variables(int n) {
+	vector<int> result;
+	for (int i = 0; i < n; i++) {
+		result.push_back(i);
+	}
+	return result;
+}
+
+static void expect_equivalent(const esop &e, const cover &c, int n) {
+	cover converted = e.to_cover();
+	vector<int> vars = variables(n);
+	for (unsigned long m = 0; m < (1ul<<n); m++) {
+		cube asg = encode_binary(m, vars);
+		EXPECT_EQ(cofactor(converted, asg).is_tautology(), cofactor(c, asg).is_tautology()) << "minterm " << m;
+	}
+}
+
+// Parity takes 2^(n-1) cubes as a cover and n as an esop
+TEST(EsopTest, Parity) {
+	const int n = 6;
+	esop e;
+	cover c;
+	for (int i = 0; i < n; i++) {
+		e ^= esop(i, 1);
+		c = c ^ cover(i, 1);
+	}
+
+	EXPECT_EQ(e.size(), n);
+	EXPECT_EQ(c.size(), 1 << (n-1));
+	expect_equivalent(e, c, n);
+
+	// Converting the cover back finds the linear form again
+	esop back(c);
+	EXPECT_EQ(back.size(), n);
+	expect_equivalent(back, c, n);
+}
+
+// Too wide for a truth table, and the cover would have 2^39 cubes
+TEST(EsopTest, WideParity) {
+	const int n = 40;
+	esop e;
+	for (int i = 0; i < n; i++) {
+		e ^= esop(i, 1);
+	}
+	EXPECT_FALSE(e.is_null());
+	EXPECT_FALSE(e.is_tautology());
+	EXPECT_TRUE((~e).size() == n+1);
+	EXPECT_FALSE((~e).is_null());
+
+	// x ^ ~x is one for each variable, so an even number of them cancel
+	esop f = e;
+	for (int i = 0; i < n; i++) {
+		f ^= esop(i, 0);
+	}
+	EXPECT_EQ(f.size(), 2*n);
+	EXPECT_TRUE(f.is_null());
+	EXPECT_FALSE(f.is_tautology());
+
+	f ^= esop(1);
+	EXPECT_FALSE(f.is_null());
+	EXPECT_TRUE(f.is_tautology());
+
+	// and the same checks still work from a table on a narrow support
+	esop g;
+	for (int i = 0; i < 8; i++) {
+		g ^= esop(i, 1);
+		g ^= esop(i, 0);
+	}
+	EXPECT_TRUE(g.is_null());
+	g ^= esop(1);
+	EXPECT_TRUE(g.is_tautology());
+	EXPECT_FALSE(esop().is_tautology());
+	EXPECT_TRUE(esop().is_null());
+	EXPECT_TRUE(esop(1).is_tautology());
+}
+
+TEST(EsopTest, Operators) {
+	const int n = 5;
+	cover a = (cover(0, 1) & cover(1, 1)) | (cover(2, 0) & cover(3, 1));
+	cover b = cover(1, 0) | (cover(3, 0) & cover(4, 1));
+	esop ea(a), eb(b);
+
+	expect_equivalent(ea, a, n);
+	expect_equivalent(eb, b, n);
+	expect_equivalent(ea & eb, a & b, n);
+	expect_equivalent(ea | eb, a | b, n);
+	expect_equivalent(ea ^ eb, a ^ b, n);
+	expect_equivalent(~ea, ~a, n);
+	expect_equivalent(cofactor(ea, 1, 1), cofactor(a, 1, 1), n);
+
+	EXPECT_TRUE((ea ^ ea).is_null());
+	EXPECT_TRUE((ea | ~ea).is_tautology());
+	EXPECT_EQ((ea ^ ea).size(), 0);
+}
+
+// Minimizing a redundant esop keeps its function and drops cubes
+TEST(EsopTest, Exorcism) {
+	const int n = 4;
+	esop e;
+	vector<int> vars = variables(n);
+	cover c;
+	// every minterm with an odd number of ones except 0111
+	for (unsigned long m = 0; m < 16; m++) {
+		if (std::popcount(m)%2 == 1 and m != 14) {
+			e.cubes.push_back(encode_binary(m, vars));
+			c |= encode_binary(m, vars);
+		}
+	}
+
+	int before = e.size();
+	e.exorcism();
+	EXPECT_LT(e.size(), before);
+	expect_equivalent(e, c, n);
+
+	for (int i = 0; i < e.size(); i++) {
+		for (int j = i+1; j < e.size(); j++) {
+			EXPECT_GE(esop_distance(e.cubes[i], e.cubes[j], NULL, NULL), 2);
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <boolean/espresso_cache.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace boolean;
+
+static std::string cache_path(const char *name) {
+	std::string path = std::string("/tmp/boolean_") + name + "_" + std::to_string(getpid()) + ".cache";
+	remove(path.c_str());
+	return path;
+}
+
+static cover sample(int offset) {
+	vector<int> vars = {0, 1, 2, 3, 4, 5};
+	cover F;
+	for (unsigned long m = 0; m < 64; m++) {
+		if ((m*37 + offset) % 7 < 4) {
+			F.push_back(encode_binary(m, vars));
+		}
+	}
+	return F;
+}
+
+TEST(EspressoCacheTest, HitAndMiss) {
+	std::string path = cache_path("hit");
+	cover F = sample(11);
+
+	cover first = F;
+	{
+		espresso_cache cache;
+		ASSERT_TRUE(cache.open(path.c_str(), 1 << 20));
+		espresso(first, cover(), cache);
+		EXPECT_EQ(cache.count(), 1);
+		EXPECT_TRUE(first == F);
+		EXPECT_LT(first.size(), F.size());
+	}
+
+	// reopening finds it, regardless of the order of the cubes
+	espresso_cache cache;
+	ASSERT_TRUE(cache.open(path.c_str()));
+	EXPECT_EQ(cache.count(), 1);
+
+	cover shuffled = F;
+	std::reverse(shuffled.begin(), shuffled.end());
+	cover found;
+	ASSERT_TRUE(cache.find(shuffled, cover(), espresso_options(), &found));
+	EXPECT_EQ(found.cubes, first.cubes);
+
+	cover second = shuffled;
+	espresso(second, cover(), cache);
+	EXPECT_EQ(second.cubes, first.cubes);
+	EXPECT_EQ(cache.count(), 1);
+
+	// other options, don't cares or functions are different entries
+	EXPECT_FALSE(cache.find(F, cover(), espresso_options(EFFORT_FAST), &found));
+	EXPECT_FALSE(cache.find(F, cover(0, 1), espresso_options(), &found));
+	EXPECT_FALSE(cache.find(sample(12), cover(), espresso_options(), &found));
+
+	cache.close();
+	remove(path.c_str());
+}
+
+TEST(EspressoCacheTest, Full) {
+	std::string path = cache_path("full");
+	espresso_cache cache;
+	ASSERT_TRUE(cache.open(path.c_str(), 4096));
+
+	int stored = 0;
+	for (int i = 0; i < 64; i++) {
+		if (cache.insert(sample(i), cover(), espresso_options(), sample(i))) {
+			stored++;
+		}
+	}
+	EXPECT_GT(stored, 0);
+	EXPECT_LT(stored, 64);
+	EXPECT_EQ(cache.count(), stored);
+
+	cover found;
+	EXPECT_TRUE(cache.find(sample(0), cover(), espresso_options(), &found));
+	EXPECT_EQ(found.cubes, sample(0).cubes);
+
+	cache.close();
+	remove(path.c_str());
+}
+
+// Readers don't lock, so they may run alongside a writer
+TEST(EspressoCacheTest, ConcurrentReaders) {
+	std::string path = cache_path("concurrent");
+	espresso_cache cache;
+	ASSERT_TRUE(cache.open(path.c_str(), 1 << 20));
+
+	std::atomic<bool> done(false);
+	std::atomic<int> bad(0);
+	vector<std::thread> readers;
+	for (int t = 0; t < 4; t++) {
+		readers.push_back(std::thread([&]() {
+			while (!done) {
+				for (int i = 0; i < 32; i++) {
+					cover found;
+					if (cache.find(sample(i), cover(), espresso_options(), &found) and found.cubes != sample(i).cubes) {
+						bad++;
+					}
+				}
+			}
+		}));
+	}
+
+	for (int i = 0; i < 32; i++) {
+		cache.insert(sample(i), cover(), espresso_options(), sample(i));
+	}
+	done = true;
+	for (int t = 0; t < 4; t++) {
+		readers[t].join();
+	}
+
+	EXPECT_EQ(bad, 0);
+	cache.close();
+	remove(path.c_str());
+}
+
+// A run that used up its budget isn't kept, another run might do better
+TEST(EspressoCacheTest, Budget) {
+	std::string path = cache_path("budget");
+	espresso_cache cache;
+	ASSERT_TRUE(cache.open(path.c_str(), 1 << 20));
+
+	cover F = sample(5);
+	cover G = F;
+	espresso(G, cover(), cache, espresso_options(EFFORT_NORMAL, -1, 0));
+	EXPECT_TRUE(G == F);
+	EXPECT_EQ(cache.count(), 0);
+
+	G = F;
+	espresso(G, cover(), cache, espresso_options(EFFORT_NORMAL, -1, 60000000));
+	EXPECT_TRUE(G == F);
+	EXPECT_EQ(cache.count(), 1);
+
+	cache.close();
+	remove(path.c_str());
+}
+
+static void patch(const std::string &path, long offset, const void *data, size_t size) {
+	FILE *fptr = fopen(path.c_str(), "r+b");
+	ASSERT_TRUE(fptr != NULL);
+	fseek(fptr, offset, SEEK_SET);
+	fwrite(data, size, 1, fptr);
+	fclose(fptr);
+}
+
+// Nothing read from the file is trusted
+TEST(EspressoCacheTest, Corrupt) {
+	std::string path = cache_path("corrupt");
+	espresso_cache::header h;
+	{
+		espresso_cache cache;
+		ASSERT_TRUE(cache.open(path.c_str(), 1 << 16));
+		ASSERT_TRUE(cache.insert(sample(0), cover(), espresso_options(), sample(0)));
+		h = *(espresso_cache::header*)cache.data;
+	}
+	uint64_t first = sizeof(h) + (uint64_t)h.slots*sizeof(uint64_t);
+
+	// a record whose length runs past the end of the file
+	uint64_t length = ~(uint64_t)0 - 8;
+	patch(path, first + 16, &length, sizeof(length));
+	{
+		espresso_cache cache;
+		ASSERT_TRUE(cache.open(path.c_str()));
+		cover found;
+		EXPECT_FALSE(cache.find(sample(0), cover(), espresso_options(), &found));
+	}
+
+	// a cube count larger than the record
+	length = 8;
+	uint32_t cubes = 1000;
+	patch(path, first + 16, &length, sizeof(length));
+	patch(path, first + 24, &cubes, sizeof(cubes));
+	{
+		espresso_cache cache;
+		ASSERT_TRUE(cache.open(path.c_str()));
+		cover found;
+		EXPECT_FALSE(cache.find(sample(0), cover(), espresso_options(), &found));
+	}
+
+	// a slot count that isn't a power of two
+	espresso_cache::header bad = h;
+	bad.slots = h.slots-1;
+	patch(path, 0, &bad, sizeof(bad));
+	{
+		espresso_cache cache;
+		EXPECT_FALSE(cache.open(path.c_str()));
+	}
+
+	// a record area that ends past the end of the file
+	bad = h;
+	bad.end = h.capacity+8;
+	patch(path, 0, &bad, sizeof(bad));
+	{
+		espresso_cache cache;
+		EXPECT_FALSE(cache.open(path.c_str()));
+	}
+
+	patch(path, 0, &h, sizeof(h));
+	{
+		espresso_cache cache;
+		EXPECT_TRUE(cache.open(path.c_str()));
+	}
+
+	remove(path.c_str());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <boolean/expression.h>
+
+#include <cstring>
+
+using namespace boolean;
+
+TEST(ExpressionTest, Parse) {
+	variable_table vars;
+	cover c;
+
+	ASSERT_TRUE(parse_expression("a&~b|c", vars, &c));
+	EXPECT_EQ(vars.names, vector<string>({"a", "b", "c"}));
+	EXPECT_TRUE(c == ((cover(0, 1) & cover(1, 0)) | cover(2, 1)));
+
+	// & binds tighter than |, and parentheses distribute
+	ASSERT_TRUE(parse_expression("(a | b) & ~(c & d)", vars, &c));
+	cover expect = (cover(0, 1) | cover(1, 1)) & ~(cover(2, 1) & cover(3, 1));
+	EXPECT_TRUE(c == expect);
+
+	ASSERT_TRUE(parse_expression("!!a & !b", vars, &c));
+	EXPECT_TRUE(c == (cover(0, 1) & cover(1, 0)));
+
+	// constants and contradictions
+	ASSERT_TRUE(parse_expression("a&~a", vars, &c));
+	EXPECT_TRUE(c.is_null());
+	ASSERT_TRUE(parse_expression("a|~a", vars, &c));
+	EXPECT_TRUE(c.is_tautology());
+	ASSERT_TRUE(parse_expression("0|b&1", vars, &c));
+	EXPECT_TRUE(c == cover(1, 1));
+	ASSERT_TRUE(parse_expression("~0", vars, &c));
+	EXPECT_TRUE(c.is_tautology());
+
+	// names past the first word
+	for (int i = 0; i < 40; i++)
+		vars.define("x" + std::to_string(i));
+	ASSERT_TRUE(parse_expression("x35&~x2|x20", vars, &c));
+	int x2 = vars.find("x2"), x20 = vars.find("x20"), x35 = vars.find("x35");
+	EXPECT_TRUE(c == ((cover(x35, 1) & cover(x2, 0)) | cover(x20, 1)));
+}
+
+TEST(ExpressionTest, Errors) {
+	variable_table vars;
+	vars.define("a");
+	vars.define("b");
+	cover c;
+
+	const char *bad[] = {"", "a&", "a|", "(a", "a)", "a b", "&a", "~"};
+	for (int i = 0; i < 8; i++)
+		EXPECT_FALSE(parse_expression(bad[i], vars, &c)) << bad[i];
+
+	// unknown names are only an error when the table is fixed
+	EXPECT_FALSE(parse_expression("a&z", vars, &c, false));
+	EXPECT_EQ(vars.find("z"), -1);
+	EXPECT_TRUE(parse_expression("a&z", vars, &c, true));
+	EXPECT_EQ(vars.find("z"), 2);
+}
+
+TEST(ExpressionTest, Library) {
+	const char *library =
+		"# guards\n"
+		"a&b\n"
+		"\n"
+		"  ~a|c\n"
+		"b&(c|d)\n";
+
+	variable_table vars;
+	vector<cover> guards;
+	ASSERT_TRUE(parse_expressions(library, strlen(library), vars, &guards));
+	ASSERT_EQ(guards.size(), 3u);
+	EXPECT_TRUE(guards[0] == (cover(0, 1) & cover(1, 1)));
+	EXPECT_TRUE(guards[1] == (cover(0, 0) | cover(2, 1)));
+	EXPECT_TRUE(guards[2] == (cover(1, 1) & (cover(2, 1) | cover(3, 1))));
+
+	// the lines before the bad one are kept, and nothing is added for it
+	const char *bad = "a&b\na&|b\n";
+	guards.clear();
+	EXPECT_FALSE(parse_expressions(bad, strlen(bad), vars, &guards));
+	ASSERT_EQ(guards.size(), 1u);
+	EXPECT_TRUE(guards[0] == (cover(0, 1) & cover(1, 1)));
+}
+
+TEST(ExpressionTest, Format) {
+	variable_table vars;
+	cover c;
+	ASSERT_TRUE(parse_expression("a&~b|c&d", vars, &c));
+
+	cover d;
+	ASSERT_TRUE(parse_expression(format_expression(c, vars), vars, &d, false));
+	EXPECT_TRUE(c == d);
+
+	EXPECT_EQ(format_expression(cover(), vars), "0");
+	EXPECT_EQ(format_expression(cover(1), vars), "1");
+	EXPECT_EQ(format_expression(cover(20, 0), vars), "~v20");
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <boolean/factor_table.h>
+#include <boolean/hash.h>
+#include <boolean/bitset.h>
+#include <boolean/unsigned_int.h>
+
+using namespace boolean;
+
+// Test insertion order and lookup
+TEST(FactorTableTest, InsertAndFind) {
+	factor_table table;
+	EXPECT_EQ(table.size(), 0);
+	EXPECT_EQ(table.find(cube(0, 1)), -1);
+
+	EXPECT_EQ(table.insert(cube(0, 1)), 0);
+	EXPECT_EQ(table.insert(cube(1, 0)), 1);
+	EXPECT_EQ(table.insert(cube(0, 1)), 0);
+	EXPECT_EQ(table.size(), 2);
+
+	EXPECT_EQ(table.find(cube(1, 0)), 1);
+	EXPECT_EQ(table.find(cube(1, 1)), -1);
+
+	// Positions survive growing the hash table
+	for (int i = 0; i < 1000; i++) {
+		cube c = cube(i, i%2) & cube(i+1000, 1);
+		EXPECT_EQ(table.insert(c), i+2);
+	}
+	for (int i = 0; i < 1000; i++) {
+		cube c = cube(i, i%2) & cube(i+1000, 1);
+		EXPECT_EQ(table.find(c), i+2);
+		EXPECT_EQ(table.factors[i+2], c);
+	}
+	EXPECT_EQ(table.find(cube(0, 1)), 0);
+}
+
+// Cubes that only differ in trailing tautology words are the same factor
+TEST(FactorTableTest, TrailingTautologies) {
+	cube a(3, 1);
+	cube b(3, 1);
+	b.extendX(4);
+	EXPECT_EQ(boolean::hash(a), boolean::hash(b));
+
+	factor_table table;
+	EXPECT_EQ(table.insert(a), 0);
+	EXPECT_EQ(table.insert(b), 0);
+	EXPECT_EQ(table.size(), 1);
+}
+
+// Decomposing through a factor table gives the same result as through a map
+TEST(FactorTableTest, Decomposition) {
+	unsigned_int a(3, 0);
+	unsigned_int b(3, 3);
+	boolean::bitset sum = a + b;
+
+	map<cube, int> factor_map;
+	factor_table table;
+	boolean::bitset by_map = sum.decompose_hfactor(factor_map, 2, 10);
+	boolean::bitset by_table = sum.decompose_hfactor(table, 2, 10);
+	EXPECT_EQ(table.to_map(10), factor_map);
+	ASSERT_EQ(by_map.bits.size(), by_table.bits.size());
+	for (int i = 0; i < (int)by_map.bits.size(); i++) {
+		EXPECT_EQ(by_map.bits[i].cubes, by_table.bits[i].cubes);
+	}
+
+	map<cube, int> ufactor_map;
+	factor_table utable;
+	unsigned_int uby_map = decompose_xfactor(unsigned_int(sum), 2, ufactor_map, 10, vector<int>());
+	unsigned_int uby_table = decompose_xfactor(unsigned_int(sum), 2, utable, 10, vector<int>());
+	EXPECT_EQ(utable.to_map(10), ufactor_map);
+	ASSERT_EQ(uby_map.bits.size(), uby_table.bits.size());
+	for (int i = 0; i < (int)uby_map.bits.size(); i++) {
+		EXPECT_EQ(uby_map.bits[i].cubes, uby_table.bits[i].cubes);
+	}
+}
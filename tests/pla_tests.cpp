@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <boolean/pla.h>
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace boolean;
+
+static const char *example =
+	"# a two output function\n"
+	".i 4\n"
+	".o 2\n"
+	".ilb a b c d\n"
+	".ob f g\n"
+	".p 4\n"
+	".type fd\n"
+	"01-1 10\n"
+	"1-0- 11\n"
+	"--11 0-\n"
+	"0000 -~\n"
+	".e\n";
+
+TEST(PlaTest, Parse) {
+	pla p;
+	ASSERT_TRUE(parse_pla(example, strlen(example), &p));
+	EXPECT_EQ(p.inputs, 4);
+	EXPECT_EQ(p.outputs, 2);
+	EXPECT_EQ(p.type, PLA_F | PLA_D);
+	EXPECT_EQ(p.input_names, vector<string>({"a", "b", "c", "d"}));
+	EXPECT_EQ(p.output_names, vector<string>({"f", "g"}));
+	ASSERT_EQ(p.on.bits.size(), 2u);
+	ASSERT_EQ(p.dc.bits.size(), 2u);
+	EXPECT_TRUE(p.off.bits.empty());
+
+	cover f = (cover(0, 0) & cover(1, 1) & cover(3, 1)) | (cover(0, 1) & cover(2, 0));
+	cover g = cover(0, 1) & cover(2, 0);
+	cover fd = cover(0, 0) & cover(1, 0) & cover(2, 0) & cover(3, 0);
+	cover gd = cover(2, 1) & cover(3, 1);
+	EXPECT_EQ(p.on.bits[0].size(), 2);
+	EXPECT_TRUE(p.on.bits[0] == f);
+	EXPECT_TRUE(p.on.bits[1] == g);
+	EXPECT_TRUE(p.dc.bits[0] == fd);
+	EXPECT_TRUE(p.dc.bits[1] == gd);
+
+	// the off-set is only read for types that have one
+	const char *fr = ".i 2\n.o 1\n.type fr\n11 1\n00 0\n";
+	ASSERT_TRUE(parse_pla(fr, strlen(fr), &p));
+	ASSERT_EQ(p.off.bits.size(), 1u);
+	EXPECT_TRUE(p.off.bits[0] == (cover(0, 0) & cover(1, 0)));
+	EXPECT_TRUE(p.dc.bits.empty());
+
+	const char *bad[] = {
+		"11 1\n",
+		".i 2\n.o 1\n1 1\n",
+		".i 2\n.o 1\n1a 1\n",
+		".i 2\n.o 1\n11 1 1\n",
+		".i 2\n.type q\n",
+	};
+	for (int i = 0; i < 5; i++) {
+		EXPECT_FALSE(parse_pla(bad[i], strlen(bad[i]), &p)) << bad[i];
+	}
+}
+
+TEST(PlaTest, RoundTrip) {
+	pla p;
+	ASSERT_TRUE(parse_pla(example, strlen(example), &p));
+
+	// wide enough to need more than one word per cube
+	p.inputs = 40;
+	p.input_names.clear();
+	p.on.bits[1] |= cover(35, 1) & cover(17, 0);
+
+	std::string path = "/tmp/boolean_pla_" + std::to_string(getpid()) + ".pla";
+	ASSERT_TRUE(write_pla(path.c_str(), p));
+
+	pla q;
+	ASSERT_TRUE(read_pla(path.c_str(), &q));
+	remove(path.c_str());
+
+	EXPECT_EQ(q.inputs, 40);
+	EXPECT_EQ(q.outputs, 2);
+	EXPECT_EQ(q.output_names, p.output_names);
+	for (int j = 0; j < 2; j++) {
+		EXPECT_TRUE(q.on.bits[j] == p.on.bits[j]) << j;
+		EXPECT_TRUE(q.dc.bits[j] == p.dc.bits[j]) << j;
+	}
+	EXPECT_EQ(format_pla(q), format_pla(p));
+
+	EXPECT_FALSE(read_pla("/nonexistent/file.pla", &q));
+}
+
+// .p counts the lines that are written, not the cubes that were skipped
+TEST(PlaTest, LineCount) {
+	pla p;
+	p.inputs = 2;
+	p.outputs = 1;
+	p.type = PLA_D;
+	p.on.bits.push_back(cover(0, 1) | cover(1, 1));
+	p.dc.bits.push_back(cover(0, 0) & cover(1, 0));
+	p.dc.bits[0].push_back(cube(0, 1) & cube(0, 0));
+	p.dc.bits.push_back(cover(1, 0));
+
+	// only the one don't care line of the one output is written
+	string text = format_pla(p);
+	EXPECT_NE(text.find(".type d\n"), string::npos);
+	ASSERT_NE(text.find(".p "), string::npos);
+	EXPECT_EQ(text.substr(text.find(".p ")), ".p 1\n00 -\n.e\n");
+}
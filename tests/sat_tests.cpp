@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <boolean/sat.h>
+
+using namespace boolean;
+
+TEST(SatTest, Solver) {
+	// x0 | x1, ~x0 | x2, ~x1 | x2, ~x2 | x3
+	sat s;
+	for (int i = 0; i < 4; i++) {
+		s.new_variable();
+	}
+	EXPECT_TRUE(s.add_clause({0, 2}));
+	EXPECT_TRUE(s.add_clause({1, 4}));
+	EXPECT_TRUE(s.add_clause({3, 4}));
+	EXPECT_TRUE(s.add_clause({5, 6}));
+	ASSERT_TRUE(s.solve());
+	EXPECT_EQ(s.model[2], 1);
+	EXPECT_EQ(s.model[3], 1);
+	EXPECT_TRUE(s.model[0] == 1 or s.model[1] == 1);
+
+	// now forbid x3
+	EXPECT_FALSE(s.add_clause({7}));
+	EXPECT_FALSE(s.solve());
+}
+
+// Four pigeons can't fit in three holes, which takes real conflict analysis
+TEST(SatTest, Pigeonhole) {
+	sat s;
+	int p[4][3];
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 3; j++) {
+			p[i][j] = s.new_variable();
+		}
+	}
+
+	for (int i = 0; i < 4; i++) {
+		s.add_clause({2*p[i][0], 2*p[i][1], 2*p[i][2]});
+	}
+	for (int j = 0; j < 3; j++) {
+		for (int i = 0; i < 4; i++) {
+			for (int k = i+1; k < 4; k++) {
+				s.add_clause({2*p[i][j]+1, 2*p[k][j]+1});
+			}
+		}
+	}
+	EXPECT_FALSE(s.solve());
+}
+
+// x0 & ~x1 | x1 & ~x2 | ... around a cycle of n variables is true unless
+// every variable has the same value, in either direction around the cycle
+static cover cycle(int n, int dir) {
+	cover result;
+	for (int i = 0; i < n; i++) {
+		result |= cover(i, dir) & cover((i+1)%n, 1-dir);
+	}
+	return result;
+}
+
+static cover same(int n, int val) {
+	cube result;
+	for (int i = 0; i < n; i++) {
+		result.set(i, val);
+	}
+	return cover(result);
+}
+
+TEST(SatTest, CoverQueries) {
+	// small enough to check against shannon expansion
+	cover a = cycle(10, 1);
+	EXPECT_EQ(sat_is_tautology(a | same(10, 1) | same(10, 0)), true);
+	EXPECT_EQ(sat_is_tautology(a | same(10, 1)), false);
+	EXPECT_EQ(sat_are_equal(a, cycle(10, 0)), true);
+	EXPECT_EQ(sat_is_subset(a, a | same(10, 1)), true);
+	EXPECT_EQ(sat_is_subset(a | same(10, 1), a), false);
+	EXPECT_EQ(sat_are_mutex(a, same(10, 0)), true);
+	EXPECT_EQ(sat_are_mutex(a, cover(3, 1)), false);
+	EXPECT_EQ(sat_is_tautology(cover()), false);
+	EXPECT_EQ(sat_is_tautology(cover(1)), true);
+	EXPECT_EQ(sat_is_subset(cover(), a), true);
+
+	// wide covers go to the solver
+	cover b = cycle(120, 1);
+	cover c = cycle(120, 0);
+	EXPECT_TRUE(b == c);
+	EXPECT_FALSE(b == (c | same(120, 1)));
+	EXPECT_TRUE((b | same(120, 0) | same(120, 1)).is_tautology());
+	EXPECT_FALSE((b | same(120, 0)).is_tautology());
+	EXPECT_TRUE(b.is_subset_of(c));
+	EXPECT_FALSE((b | same(120, 0)).is_subset_of(c));
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <boolean/bitset.h>
+#include <boolean/parallel.h>
+#include <boolean/task.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+
+using namespace boolean;
+
+TEST(TaskTest, Scope) {
+	EXPECT_EQ(current_task(), nullptr);
+	EXPECT_FALSE(is_cancelled());
+
+	task outer, inner;
+	{
+		task_scope a(&outer);
+		EXPECT_EQ(current_task(), &outer);
+		{
+			task_scope b(&inner);
+			EXPECT_EQ(current_task(), &inner);
+			inner.cancel();
+			EXPECT_TRUE(is_cancelled());
+		}
+		EXPECT_EQ(current_task(), &outer);
+		EXPECT_FALSE(is_cancelled());
+
+		// worker threads see the task that started them
+		task *seen[2] = {nullptr, nullptr};
+		fork_join(2,
+			[&](int t) { seen[0] = current_task(); },
+			[&](int t) { seen[1] = current_task(); });
+		EXPECT_EQ(seen[0], &outer);
+		EXPECT_EQ(seen[1], &outer);
+
+		std::atomic<int> count(0);
+		parallel_for(0, 8, 4, [&](int i) {
+			if (current_task() == &outer) {
+				count++;
+			}
+		});
+		EXPECT_EQ(count, 8);
+	}
+	EXPECT_EQ(current_task(), nullptr);
+}
+
+// A task with a parent and a budget is cancelled by either one, and passes
+// its progress up
+TEST(TaskTest, Budget) {
+	task parent;
+	int reports = 0;
+	parent.progress = [&](const char *phase, int done, int total) {
+		reports++;
+	};
+
+	task unlimited(&parent, -1);
+	EXPECT_FALSE(unlimited.is_cancelled());
+	unlimited.report("phase", 0, -1);
+	EXPECT_EQ(reports, 1);
+
+	task spent(&parent, 0);
+	EXPECT_TRUE(spent.is_cancelled());
+
+	task later(&parent, 60000000);
+	EXPECT_FALSE(later.is_cancelled());
+	parent.cancel();
+	EXPECT_TRUE(later.is_cancelled());
+	EXPECT_TRUE(unlimited.is_cancelled());
+}
+
+static cover sample() {
+	vector<int> vars = {0, 1, 2, 3, 4, 5};
+	cover F;
+	for (unsigned long m = 0; m < 64; m++) {
+		if ((m*37 + 11) % 7 < 4) {
+			F.push_back(encode_binary(m, vars));
+		}
+	}
+	return F;
+}
+
+TEST(TaskTest, Progress) {
+	cover F = sample();
+	vector<std::string> phases;
+	task t;
+	t.progress = [&](const char *phase, int done, int total) {
+		phases.push_back(phase);
+	};
+
+	{
+		task_scope scope(&t);
+		espresso(F, cover(), ~F, espresso_options(EFFORT_STRONG));
+	}
+	ASSERT_GT(phases.size(), 0u);
+	EXPECT_EQ(phases[0], "espresso");
+	EXPECT_NE(find(phases.begin(), phases.end(), "last gasp"), phases.end());
+}
+
+// A cancelled espresso stops early but still returns a cover of F, as long
+// as the off-set was computed before the task was cancelled
+TEST(TaskTest, CancelEspresso) {
+	cover F = sample();
+	cover R = ~F;
+	cover G = F;
+	int reports = 0;
+	task t;
+	t.progress = [&](const char *phase, int done, int total) {
+		reports++;
+	};
+	t.cancel();
+	{
+		task_scope scope(&t);
+		espresso(G, cover(), R, espresso_options(EFFORT_STRONG));
+	}
+	EXPECT_EQ(reports, 0);
+	EXPECT_TRUE(G == F);
+}
+
+// A cancelled decomposition leaves the function as it is
+TEST(TaskTest, CancelDecompose) {
+	bitset dut;
+	for (int i = 0; i < 4; i++) {
+		cover bit;
+		for (int j = 0; j < 6; j++) {
+			cube c;
+			c.set(j, 1);
+			c.set((j+i+1)%8, (i+j)%2);
+			c.set(8+i, 1);
+			bit.push_back(c);
+		}
+		dut.bits.push_back(bit);
+	}
+
+	task t;
+	t.cancel();
+	std::map<cube, int> factors;
+	bitset result;
+	{
+		task_scope scope(&t);
+		result = dut.decompose_xfactor(factors, 2, 16, vector<int>(), 4);
+	}
+	EXPECT_TRUE(factors.empty());
+	ASSERT_EQ(result.bits.size(), dut.bits.size());
+	for (int i = 0; i < (int)dut.bits.size(); i++) {
+		EXPECT_TRUE(result.bits[i] == dut.bits[i]);
+	}
+}
+
+// A comparison cut short by a cancel never claims two covers are equal
+TEST(TaskTest, CancelCompare) {
+	// too many variables for a truth table and too few for the solver
+	cover F, G;
+	for (int i = 0; i < 20; i++) {
+		F.push_back(cube(i, 1) & cube((i+1)%20, 0));
+		G.push_back(cube(i, 1) & cube((i+3)%20, 0));
+	}
+	cube c = cube(0, 1) & cube(1, 0);
+
+	task t;
+	t.cancel();
+	task_scope scope(&t);
+	EXPECT_FALSE(F == G);
+	EXPECT_TRUE(F != G);
+	EXPECT_FALSE(F == c);
+	EXPECT_FALSE(c == F);
+	EXPECT_TRUE(F != c);
+	EXPECT_TRUE(c != F);
+}
+
+// Cancelling part way through espresso, while the complements and solver
+// queries are running, still leaves a cover of F
+TEST(TaskTest, CancelEspressoMidway) {
+	cover F;
+	for (int i = 0; i < 40; i++) {
+		F.push_back(cube(i, 1) & cube((i+1)%40, 0) & cube((i+7)%40, 1));
+	}
+
+	for (int delay : {0, 1000, 5000, 20000}) {
+		task t;
+		cover G = F;
+		std::thread worker([&]() {
+			task_scope scope(&t);
+			espresso(G, cover());
+		});
+		std::this_thread::sleep_for(std::chrono::microseconds(delay));
+		t.cancel();
+		worker.join();
+		EXPECT_TRUE(G == F) << delay;
+	}
+}
+
+// Cancelling part way through a decomposition leaves the rest of the tree
+// as leaves, so substituting the factors back in gives the input. Most of
+// the time goes to the first complement, so the cancels are spread over
+// the second half of an uncancelled run.
+TEST(TaskTest, CancelDecomposeMidway) {
+	bitset dut;
+	for (int i = 0; i < 6; i++) {
+		cover bit;
+		for (int j = 0; j < 10; j++) {
+			cube c;
+			c.set(j, 1);
+			c.set((j+i+1)%12, (i+j)%2);
+			c.set((j*5+i)%12, (i*j)%2);
+			c.set(12+i%3, 1);
+			bit.push_back(c);
+		}
+		dut.bits.push_back(bit);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::map<cube, int> factors;
+		dut.decompose_xfactor(factors, 2, 16, vector<int>(), 4);
+	}
+	long total = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	for (int k = 0; k <= 10; k++) {
+		task t;
+		std::map<cube, int> factors;
+		bitset result;
+		std::thread worker([&]() {
+			task_scope scope(&t);
+			result = dut.decompose_xfactor(factors, 2, 16, vector<int>(), 4);
+		});
+		std::this_thread::sleep_for(std::chrono::microseconds(total/2 + total*k/20));
+		t.cancel();
+		worker.join();
+
+		ASSERT_EQ(result.bits.size(), dut.bits.size());
+		for (int i = 0; i < (int)result.bits.size(); i++) {
+			cover bit = result.bits[i];
+			for (auto f = factors.begin(); f != factors.end(); f++) {
+				cover common(f->first);
+				bit = (boolean::cofactor(bit, f->second, 1) & common) | (boolean::cofactor(bit, f->second, 0) & ~common);
+			}
+			EXPECT_TRUE(bit == dut.bits[i]) << k << " " << i;
+		}
+	}
+}
+
+// Another thread can stop a tautology check that would run for a long time
+TEST(TaskTest, CancelFromAnotherThread) {
+	cover c;
+	for (int i = 0; i < 40; i++) {
+		c |= cover(i, 1) & cover((i+1)%40, 0) & cover((i+7)%40, 1);
+	}
+
+	task t;
+	std::thread worker([&]() {
+		task_scope scope(&t);
+		while (!is_cancelled()) {
+			(~c).is_tautology();
+		}
+	});
+	t.cancel();
+	worker.join();
+	EXPECT_TRUE(t.is_cancelled());
+}
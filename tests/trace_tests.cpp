@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <boolean/trace.h>
+
+#include <cstdio>
+#include <unistd.h>
+
+using namespace boolean;
+
+static std::string temp(const char *name)
+{
+	return "/tmp/boolean_trace_" + std::to_string(getpid()) + "_" + name + ".trace";
+}
+
+TEST(TraceTest, Record) {
+	std::string path = temp("record");
+
+	cover F = (cover(0, 1) & cover(1, 1)) | (cover(0, 1) & cover(1, 0)) | (cover(2, 0) & cover(20, 1));
+	cover D = cover(3, 1) & cover(4, 1);
+
+	// nothing is recorded until tracing starts
+	~F;
+	ASSERT_TRUE(trace_begin(path.c_str()));
+	EXPECT_TRUE(is_tracing());
+
+	cover nF = ~F;
+	EXPECT_FALSE(F.is_tautology());
+	cover G = F;
+	espresso(G, D, nF, espresso_options(EFFORT_STRONG, 3, 1000000));
+	cover H = F;
+	espresso(H, D);
+
+	bitset b;
+	b.bits.push_back(F);
+	b.bits.push_back(D);
+	factor_table factors;
+	b.decompose_hfactor(factors, 2, 30, vector<int>({3}), 2);
+
+	trace_end();
+	EXPECT_FALSE(is_tracing());
+	~F;
+
+	// only the outermost calls show up, not the complements and tautology
+	// checks espresso and the decomposition make on their own
+	vector<trace_record> records;
+	ASSERT_TRUE(read_trace(path.c_str(), &records));
+	ASSERT_EQ(records.size(), 5u);
+
+	EXPECT_EQ(records[0].kind, TRACE_COMPLEMENT);
+	ASSERT_EQ(records[0].covers.size(), 1u);
+	EXPECT_TRUE(records[0].covers[0] == F);
+
+	EXPECT_EQ(records[1].kind, TRACE_TAUTOLOGY);
+
+	EXPECT_EQ(records[2].kind, TRACE_ESPRESSO);
+	ASSERT_EQ(records[2].covers.size(), 3u);
+	EXPECT_TRUE(records[2].covers[0] == F);
+	EXPECT_TRUE(records[2].covers[1] == D);
+	EXPECT_TRUE(records[2].covers[2] == nF);
+	EXPECT_EQ(records[2].options.effort, EFFORT_STRONG);
+	EXPECT_EQ(records[2].options.iterations, 3);
+	EXPECT_EQ(records[2].options.budget, 1000000);
+
+	EXPECT_EQ(records[3].kind, TRACE_ESPRESSO_NOOFFSET);
+	ASSERT_EQ(records[3].covers.size(), 2u);
+
+	EXPECT_EQ(records[4].kind, TRACE_HFACTOR);
+	ASSERT_EQ(records[4].covers.size(), 2u);
+	EXPECT_EQ(records[4].width, 2);
+	EXPECT_EQ(records[4].offset, 30);
+	EXPECT_EQ(records[4].hide, vector<int>({3}));
+	EXPECT_EQ(records[4].threads, 2);
+
+	for (int i = 0; i < (int)records.size(); i++)
+		EXPECT_GE(replay(records[i]), 0);
+
+	unlink(path.c_str());
+}
+
+TEST(TraceTest, Truncated) {
+	std::string path = temp("truncated");
+
+	cover F = (cover(0, 1) & cover(1, 1)) | cover(2, 0);
+	ASSERT_TRUE(trace_begin(path.c_str()));
+	~F;
+	trace_end();
+
+	vector<trace_record> records;
+	ASSERT_TRUE(read_trace(path.c_str(), &records));
+	ASSERT_EQ(records.size(), 1u);
+
+	// a record cut off part way through is an error
+	FILE *fptr = fopen(path.c_str(), "rb");
+	ASSERT_TRUE(fptr != NULL);
+	fseek(fptr, 0, SEEK_END);
+	long size = ftell(fptr);
+	fclose(fptr);
+	ASSERT_EQ(truncate(path.c_str(), size-4), 0);
+
+	records.clear();
+	EXPECT_FALSE(read_trace(path.c_str(), &records));
+	EXPECT_FALSE(read_trace("/nonexistent/trace", &records));
+
+	unlink(path.c_str());
+}
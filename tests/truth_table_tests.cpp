@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <boolean/truth_table.h>
+
+using namespace boolean;
+
+// A function of variables spread far apart, so the support has to be
+// remapped onto a small table
+static cover sample(const vector<int> &v) {
+	return (cover(v[0], 1) & cover(v[1], 0)) | (cover(v[2], 1) & cover(v[7], 1)) | (cover(v[3], 0) & cover(v[8], 0) & cover(v[5], 1)) | cover(v[9], 1);
+}
+
+TEST(TruthTableTest, RoundTrip) {
+	vector<int> support = {3, 17, 40, 41, 65, 100, 101, 130, 200, 255};
+	cover c = sample(support);
+	truth_table t(c, support);
+	EXPECT_EQ(t.vars, 10);
+	EXPECT_EQ(t.words.size(), size_t(16));
+
+	cover back = t.to_cover(support);
+	EXPECT_TRUE(back == c);
+	EXPECT_EQ(truth_table(back, support), t);
+
+	truth_table n = ~t;
+	EXPECT_TRUE((n & t).is_null());
+	EXPECT_TRUE((n | t).is_tautology());
+	EXPECT_TRUE(n.to_cover(support) == ~c);
+	EXPECT_TRUE((n ^ t).is_tautology());
+}
+
+TEST(TruthTableTest, Cofactor) {
+	vector<int> support = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+	cover c = sample(support);
+	truth_table t(c, support);
+	for (int v = 0; v < 10; v++) {
+		for (int val = 0; val < 2; val++) {
+			truth_table expected(cofactor(c, v, val), support);
+			EXPECT_EQ(cofactor(t, v, val), expected) << "variable " << v << " = " << val;
+		}
+	}
+
+	// small tables use only part of a word
+	truth_table x(cover(0, 1) & cover(2, 0), {0, 1, 2});
+	EXPECT_EQ(x.words[0], 0x0Aul);
+	EXPECT_TRUE(cofactor(x, 1, 1) == x);
+	EXPECT_TRUE((~x).is_subset_of(truth_table(3, 1)));
+	EXPECT_FALSE(x.is_subset_of(cofactor(x, 0, 0)));
+}
+
+// Covers with a small support are compared through truth tables
+TEST(TruthTableTest, CoverQueries) {
+	// x0..x11 each on their own or negated in a chain, with a support of 12
+	cover c;
+	for (int i = 0; i < 12; i++) {
+		c |= cover(i, 1) & cover((i+1)%12, 0);
+	}
+	EXPECT_FALSE(c.is_tautology());
+
+	cover all = c;
+	for (int i = 0; i < 12; i++) {
+		all |= cover(i, 1);
+	}
+	all |= cover(0, 0);
+	EXPECT_TRUE(all.is_tautology());
+
+	cover a = cover(0, 1) & (cover(10, 1) | cover(11, 0));
+	cover b = (cover(0, 1) & cover(10, 1)) | (cover(0, 1) & cover(11, 0));
+	EXPECT_TRUE(a == b);
+	EXPECT_TRUE(a.is_subset_of(b | cover(5, 1)));
+	EXPECT_FALSE((b | cover(5, 1)).is_subset_of(a));
+
+	vector<int> support;
+	EXPECT_TRUE(small_support(a, c, &support));
+	EXPECT_EQ(support.size(), size_t(12));
+	EXPECT_FALSE(small_support(a, c, &support, 11));
+}
@@ -0,0 +1,75 @@
+/*
+ * replay.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: nbingham
+ */
+
+#include <boolean/trace.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace boolean;
+
+// Re-run every call in a trace and report how long each kind of call took.
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		printf("usage: %s <trace> [repeat] [-v]\n", argv[0]);
+		return 1;
+	}
+
+	int repeat = 1;
+	bool verbose = false;
+	for (int i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "-v") == 0)
+			verbose = true;
+		else
+			repeat = atoi(argv[i]);
+	}
+	if (repeat < 1)
+		repeat = 1;
+
+	vector<trace_record> records;
+	if (!read_trace(argv[1], &records)) {
+		printf("error: unable to read trace %s\n", argv[1]);
+		return 1;
+	}
+
+	const char *names[6] = {"espresso", "espresso_nooffset", "complement", "tautology", "hfactor", "xfactor"};
+	long total[6] = {0, 0, 0, 0, 0, 0};
+	int count[6] = {0, 0, 0, 0, 0, 0};
+	for (int i = 0; i < (int)records.size(); i++) {
+		int kind = records[i].kind;
+		if (kind < 0 or kind >= 6)
+			continue;
+
+		// keep the fastest run to cut down on noise
+		long best = -1;
+		for (int r = 0; r < repeat; r++) {
+			long t = replay(records[i]);
+			if (best < 0 or t < best)
+				best = t;
+		}
+
+		total[kind] += best;
+		count[kind]++;
+		if (verbose) {
+			int cubes = 0;
+			for (int j = 0; j < (int)records[i].covers.size(); j++)
+				cubes += records[i].covers[j].size();
+			printf("%d %s cubes=%d %ldus\n", i, names[kind], cubes, best);
+		}
+	}
+
+	long all = 0;
+	for (int k = 0; k < 6; k++) {
+		if (count[k] > 0)
+			printf("%-18s %8d calls %12ldus\n", names[k], count[k], total[k]);
+		all += total[k];
+	}
+	printf("%-18s %8d calls %12ldus\n", "total", (int)records.size(), all);
+	return 0;
+}